@@ -0,0 +1,116 @@
+#include "ExpectimaxSearch.hpp"
+#include "../Game/BoardSymmetry.hpp"
+
+#include <algorithm>
+
+const float ExpectimaxSearch::MIN_PROBABILITY = 0.0001f;
+
+ExpectimaxSearch::ExpectimaxSearch(const Heuristic& heuristic, TranspositionTable& table) : m_heuristic(heuristic), m_table(table) {}
+
+ExpectimaxSearch::Result ExpectimaxSearch::search(Bitboard::Board board, double budgetMilliseconds, int maxDepth, const std::atomic<bool>* cancel,
+    const IterationCallback& onIteration) {
+    Clock::time_point start = Clock::now();
+    m_deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(budgetMilliseconds));
+    m_cancel = cancel;
+    m_mayStop = false;
+    m_stopped = false;
+    m_nodes = 0;
+    m_table.newSearch();
+
+    struct RootMove {
+        int move;
+        Bitboard::Board board;
+        float score;
+    };
+    RootMove moves[4];
+    int moveCount = 0;
+    for (int move = 0; move < 4; move++) {
+        Bitboard::Board moved = Bitboard::move(board, static_cast<Bitboard::EDirection>(move));
+        if (moved != board) moves[moveCount++] = { move, moved, 0.f };
+    }
+
+    Result result;
+    for (int depth = 1; depth <= std::max(maxDepth, 1) && moveCount > 0; depth++) {
+        for (int i = 0; i < moveCount && !m_stopped; i++) {
+            moves[i].score = chanceNode(moves[i].board, depth, 1.f);
+        }
+        if (m_stopped) break;
+
+        // the next iteration starts with the moves that look best now
+        std::stable_sort(moves, moves + moveCount, [](const RootMove& a, const RootMove& b) { return a.score > b.score; });
+        result.move = moves[0].move;
+        result.score = moves[0].score;
+        result.depth = depth;
+        m_mayStop = true;
+        if (onIteration) {
+            result.nodes = m_nodes;
+            result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            onIteration(result);
+        }
+
+        if (moveCount == 1 || shouldStop()) break; // a forced move needs no deeper look
+    }
+
+    result.nodes = m_nodes;
+    result.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
+
+float ExpectimaxSearch::maxNode(Bitboard::Board board, int depth, float probability) {
+    m_nodes++;
+    if (m_nodes % CLOCK_CHECK_INTERVAL == 0 && shouldStop()) m_stopped = true; // before the leaf return, most nodes are leaves
+    if (m_stopped) return 0.f;
+    if (depth == 0 || probability < MIN_PROBABILITY) return m_heuristic.evaluate(board);
+
+    int symmetry;
+    Bitboard::Board key = BoardSymmetry::canonicalize(board, symmetry);
+    TranspositionTable::Entry entry;
+    int first = 0;
+    if (m_table.probe(key, entry)) {
+        if (entry.depth >= depth) return entry.score;
+        if (entry.move != TranspositionTable::NO_MOVE) {
+            first = static_cast<int>(BoardSymmetry::mapDirection(static_cast<Bitboard::EDirection>(entry.move), BoardSymmetry::inverse(symmetry)));
+        }
+    }
+
+    float best = 0.f; // no legal move, the game is lost
+    int bestMove = NO_MOVE;
+    for (int i = 0; i < 4; i++) {
+        int move = (first + i) % 4; // the cached best move first
+        Bitboard::Board moved = Bitboard::move(board, static_cast<Bitboard::EDirection>(move));
+        if (moved == board) continue;
+
+        float score = chanceNode(moved, depth, probability);
+        if (m_stopped) return 0.f;
+        if (bestMove == NO_MOVE || score > best) {
+            best = score;
+            bestMove = move;
+        }
+    }
+
+    int storedMove = bestMove == NO_MOVE ? TranspositionTable::NO_MOVE : static_cast<int>(BoardSymmetry::mapDirection(static_cast<Bitboard::EDirection>(bestMove), symmetry));
+    m_table.store(key, depth, best, storedMove);
+    return best;
+}
+
+float ExpectimaxSearch::chanceNode(Bitboard::Board board, int depth, float probability) {
+    int empty = Bitboard::countEmpty(board); // at least one, a move that changes the board frees a cell
+    float cellProbability = probability / empty;
+
+    float sum = 0.f;
+    for (int i = 0; i < 16; i++) {
+        if ((board >> (4 * i)) & 0xF) continue;
+
+        Bitboard::Board two = board | (static_cast<Bitboard::Board>(1) << (4 * i));
+        Bitboard::Board four = board | (static_cast<Bitboard::Board>(2) << (4 * i));
+        sum += 0.9f * maxNode(two, depth - 1, cellProbability * 0.9f);
+        sum += 0.1f * maxNode(four, depth - 1, cellProbability * 0.1f);
+        if (m_stopped) return 0.f;
+    }
+    return sum / empty;
+}
+
+bool ExpectimaxSearch::shouldStop() {
+    if (!m_mayStop) return false;
+    return (m_cancel && m_cancel->load(std::memory_order_relaxed)) || Clock::now() >= m_deadline;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Heuristic.hpp"
+#include "TranspositionTable.hpp"
+#include "../Game/Bitboard.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// Expectimax over player moves and tile spawns, searched with iterative deepening
+// under a wall-clock budget. Depth counts player moves. An iteration that runs out
+// of time is thrown away, so the answer always comes from the deepest one that
+// finished; the first iteration always finishes. Root moves are tried in the order
+// of the previous iteration's scores, and results are cached by canonical board in
+// the transposition table, which carries the best move over from one iteration to
+// the next. Spawns less likely than MIN_PROBABILITY are cut off with the heuristic.
+class ExpectimaxSearch {
+public:
+    static const int NO_MOVE = -1;
+    static const int MAX_DEPTH = 16;
+
+    struct Result {
+        int move = NO_MOVE; // a Bitboard::EDirection, NO_MOVE when the game is over
+        float score = 0.f;
+        int depth = 0; // of the deepest completed iteration
+        uint64_t nodes = 0;
+        double milliseconds = 0.0;
+    };
+
+    ExpectimaxSearch(const Heuristic& heuristic, TranspositionTable& table); // the table may be shared, not the search
+
+    typedef std::function<void(const Result&)> IterationCallback; // after every completed iteration
+
+    Result search(Bitboard::Board board, double budgetMilliseconds, int maxDepth = MAX_DEPTH, const std::atomic<bool>* cancel = nullptr,
+        const IterationCallback& onIteration = nullptr);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static const float MIN_PROBABILITY;
+    static const uint64_t CLOCK_CHECK_INTERVAL = 1024; // nodes
+
+    float maxNode(Bitboard::Board board, int depth, float probability);
+    float chanceNode(Bitboard::Board board, int depth, float probability);
+    bool shouldStop();
+
+    const Heuristic& m_heuristic;
+    TranspositionTable& m_table;
+
+    Clock::time_point m_deadline;
+    const std::atomic<bool>* m_cancel = nullptr;
+    bool m_mayStop = false; // false during the first iteration
+    bool m_stopped = false;
+    uint64_t m_nodes = 0;
+};
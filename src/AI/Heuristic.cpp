@@ -0,0 +1,131 @@
+#include "Heuristic.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+static float Heuristic::Weights::* const MEMBERS[Heuristic::Weights::COUNT] = {
+    &Heuristic::Weights::base, &Heuristic::Weights::empty, &Heuristic::Weights::merges,
+    &Heuristic::Weights::monotonicity, &Heuristic::Weights::monotonicityPower, &Heuristic::Weights::smoothness,
+    &Heuristic::Weights::corner, &Heuristic::Weights::sum, &Heuristic::Weights::sumPower
+};
+
+static const char* const NAMES[Heuristic::Weights::COUNT] = {
+    "base", "empty", "merges", "monotonicity", "monotonicityPower", "smoothness", "corner", "sum", "sumPower"
+};
+
+float Heuristic::Weights::get(int index) const {
+    return this->*MEMBERS[index];
+}
+
+void Heuristic::Weights::set(int index, float value) {
+    this->*MEMBERS[index] = value;
+}
+
+const char* Heuristic::Weights::getName(int index) {
+    return NAMES[index];
+}
+
+bool Heuristic::Weights::parse(const std::string& text) {
+    Weights parsed = *this;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) return false;
+
+        std::string name = item.substr(0, equals);
+        const char* value = item.c_str() + equals + 1;
+        char* end;
+        float number = std::strtof(value, &end);
+        if (end == value || *end != '\0') return false;
+
+        int index = 0;
+        while (index < COUNT && name != NAMES[index]) index++;
+        if (index == COUNT) return false;
+        parsed.set(index, number);
+    }
+    *this = parsed;
+    return true;
+}
+
+std::string Heuristic::Weights::toString() const {
+    std::ostringstream stream;
+    for (int i = 0; i < COUNT; i++) {
+        if (i > 0) stream << ',';
+        stream << NAMES[i] << '=' << get(i);
+    }
+    return stream.str();
+}
+
+Heuristic::Heuristic() : Heuristic(Weights()) {}
+
+Heuristic::Heuristic(const Weights& weights) : m_lineScores(65536) {
+    setWeights(weights);
+}
+
+void Heuristic::setWeights(const Weights& weights) {
+    m_weights = weights;
+
+    for (uint32_t line = 0; line < 65536; line++) {
+        int cells[4];
+        for (int i = 0; i < 4; i++) cells[i] = (line >> (4 * i)) & 0xF;
+
+        float sum = 0.f;
+        int empty = 0;
+        for (int i = 0; i < 4; i++) {
+            sum += std::pow(static_cast<float>(cells[i]), weights.sumPower);
+            if (cells[i] == 0) empty++;
+        }
+
+        // equal tiles next to each other once the gaps close
+        int merges = 0;
+        int previous = 0;
+        int run = 0;
+        for (int i = 0; i < 4; i++) {
+            if (cells[i] == 0) continue;
+            if (cells[i] == previous) run++;
+            else {
+                if (run > 0) merges += 1 + run;
+                run = 0;
+                previous = cells[i];
+            }
+        }
+        if (run > 0) merges += 1 + run;
+
+        float towardStart = 0.f;
+        float towardEnd = 0.f;
+        float roughness = 0.f;
+        for (int i = 1; i < 4; i++) {
+            float a = std::pow(static_cast<float>(cells[i - 1]), weights.monotonicityPower);
+            float b = std::pow(static_cast<float>(cells[i]), weights.monotonicityPower);
+            if (cells[i - 1] > cells[i]) towardStart += a - b;
+            else towardEnd += b - a;
+            if (cells[i - 1] && cells[i]) roughness += static_cast<float>(std::abs(cells[i - 1] - cells[i]));
+        }
+
+        m_lineScores[line] = weights.base
+            + weights.empty * empty
+            + weights.merges * merges
+            - weights.monotonicity * std::min(towardStart, towardEnd)
+            - weights.smoothness * roughness
+            + weights.corner * std::max(cells[0], cells[3])
+            - weights.sum * sum;
+    }
+}
+
+const Heuristic::Weights& Heuristic::getWeights() const {
+    return m_weights;
+}
+
+float Heuristic::evaluate(Bitboard::Board board) const {
+    const float* scores = m_lineScores.data();
+    Bitboard::Board transposed = Bitboard::transpose(board);
+    return scores[board & 0xFFFF] + scores[(board >> 16) & 0xFFFF] + scores[(board >> 32) & 0xFFFF] + scores[board >> 48]
+        + scores[transposed & 0xFFFF] + scores[(transposed >> 16) & 0xFFFF] + scores[(transposed >> 32) & 0xFFFF] + scores[transposed >> 48];
+}
+
+float Heuristic::evaluateLine(uint16_t line) const {
+    return m_lineScores[line];
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../Game/Bitboard.hpp"
+
+#include <string>
+#include <vector>
+
+// Static evaluation of a board for search leaves. Every term only looks at one line
+// of four cells, so the score of all 65536 possible lines is precomputed and a board
+// costs four row and four column lookups plus a sum. The weights can be changed at
+// run time, which rebuilds the table.
+class Heuristic {
+public:
+    struct Weights {
+        static const int COUNT = 9;
+
+        float base = 200000.f; // per line, keeps live boards far above lost ones, which score 0
+        float empty = 270.f; // per empty cell
+        float merges = 700.f; // per pair of equal tiles that could merge
+        float monotonicity = 47.f; // penalty for the smaller of the two non-monotonic sums
+        float monotonicityPower = 4.f;
+        float smoothness = 0.f; // penalty per exponent step between neighbouring tiles
+        float corner = 0.f; // reward for the larger end tile of each line
+        float sum = 11.f; // penalty for the sum of tile values raised to sumPower
+        float sumPower = 3.5f;
+
+        float get(int index) const;
+        void set(int index, float value);
+        static const char* getName(int index);
+
+        bool parse(const std::string& text); // "empty=270,merges=700", unnamed weights keep their value
+        std::string toString() const;
+    };
+
+    Heuristic();
+    explicit Heuristic(const Weights& weights);
+
+    void setWeights(const Weights& weights); // not while another thread evaluates
+    const Weights& getWeights() const;
+
+    float evaluate(Bitboard::Board board) const;
+    float evaluateLine(uint16_t line) const;
+
+private:
+    Weights m_weights;
+    std::vector<float> m_lineScores; // indexed by the 16-bit line, cell 0 in the low nibble
+};
@@ -0,0 +1,72 @@
+#include "HintEngine.hpp"
+
+HintEngine::HintEngine(std::function<void()> onHint)
+    : m_table(TABLE_MEGABYTES), m_search(m_heuristic, m_table), m_onHint(onHint), m_hint(0), m_cancel(false)
+{
+    m_worker = std::thread(&HintEngine::workerLoop, this);
+}
+
+HintEngine::~HintEngine() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cancel = true;
+    m_condition.notify_one();
+    m_worker.join();
+}
+
+void HintEngine::analyse(Bitboard::Board board, uint32_t position) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingBoard = board;
+        m_pendingPosition = position;
+        m_hasRequest = true;
+    }
+    m_cancel = true;
+    m_condition.notify_one();
+}
+
+void HintEngine::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hasRequest = false;
+    }
+    m_cancel = true;
+}
+
+HintEngine::Hint HintEngine::getHint() const {
+    uint64_t packed = m_hint.load(std::memory_order_acquire);
+    Hint hint;
+    hint.position = static_cast<uint32_t>(packed >> 32);
+    hint.depth = static_cast<int>((packed >> 8) & 0xFF);
+    hint.move = static_cast<int>(packed & 0xFF) - 1;
+    return hint;
+}
+
+void HintEngine::workerLoop() {
+    for (;;) {
+        Bitboard::Board board;
+        uint32_t position;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_hasRequest || m_stopping; });
+            if (m_stopping) return;
+
+            board = m_pendingBoard;
+            position = m_pendingPosition;
+            m_hasRequest = false;
+            m_cancel = false; // under the lock, so a newer request cannot slip in between
+        }
+
+        m_search.search(board, MAX_ANALYSIS_TIME, ExpectimaxSearch::MAX_DEPTH, &m_cancel, [this, position](const ExpectimaxSearch::Result& result) {
+            if (!m_cancel.load(std::memory_order_relaxed)) publish(position, result);
+        });
+    }
+}
+
+void HintEngine::publish(uint32_t position, const ExpectimaxSearch::Result& result) {
+    uint64_t packed = static_cast<uint64_t>(position) << 32 | static_cast<uint64_t>(result.depth & 0xFF) << 8 | static_cast<uint64_t>(result.move + 1);
+    m_hint.store(packed, std::memory_order_release);
+    if (m_onHint) m_onHint();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "ExpectimaxSearch.hpp"
+#include "Heuristic.hpp"
+#include "TranspositionTable.hpp"
+#include "../Game/Bitboard.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Analyses positions on a worker thread while the game goes on. Every completed
+// search iteration publishes its best move into one atomic word, so readers on any
+// thread get the deepest suggestion so far without locks. A new position or cancel()
+// stops the running search at its next clock check.
+class HintEngine {
+public:
+    struct Hint {
+        uint32_t position = 0; // as passed to analyse(), 0 before the first hint
+        int move = ExpectimaxSearch::NO_MOVE;
+        int depth = 0;
+    };
+
+    explicit HintEngine(std::function<void()> onHint = nullptr); // onHint runs on the worker after each new hint
+    ~HintEngine();
+
+    HintEngine(const HintEngine&) = delete;
+    HintEngine& operator=(const HintEngine&) = delete;
+
+    void analyse(Bitboard::Board board, uint32_t position); // position tells the hints of different boards apart
+    void cancel();
+    Hint getHint() const;
+
+private:
+    static constexpr double MAX_ANALYSIS_TIME = 10000.0; // milliseconds per position, deeper takes too long to matter
+    static const size_t TABLE_MEGABYTES = 32;
+
+    void workerLoop();
+    void publish(uint32_t position, const ExpectimaxSearch::Result& result);
+
+    Heuristic m_heuristic;
+    TranspositionTable m_table;
+    ExpectimaxSearch m_search;
+    std::function<void()> m_onHint;
+
+    std::atomic<uint64_t> m_hint; // position << 32 | depth << 8 | move + 1
+    std::atomic<bool> m_cancel;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    Bitboard::Board m_pendingBoard = 0; // guarded by m_mutex
+    uint32_t m_pendingPosition = 0;
+    bool m_hasRequest = false;
+    bool m_stopping = false;
+    std::thread m_worker;
+};
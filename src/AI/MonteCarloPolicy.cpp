@@ -0,0 +1,211 @@
+#include "MonteCarloPolicy.hpp"
+#include "../Game/HeadlessGame.hpp"
+#include "../Utilities/Hash.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+const int MonteCarloPolicy::LANES; // std::min takes it by reference
+
+static uint64_t nextRandom(uint64_t& state) { // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1DULL;
+}
+
+static Bitboard::Board spawn(Bitboard::Board board, uint64_t& random, int& fourSpawns) {
+    Bitboard::Board spawned = Bitboard::spawnTile(board, static_cast<uint32_t>(nextRandom(random) >> 32));
+    if (((spawned ^ board) >> 1) & 0x1111111111111111ULL) fourSpawns++; // same test as HeadlessGame
+    return spawned;
+}
+
+double MonteCarloPolicy::Stats::getRolloutsPerSecond() const {
+    return seconds > 0.0 ? rollouts / seconds : 0.0;
+}
+
+MonteCarloPolicy::MonteCarloPolicy(int rolloutsPerMove, unsigned int threadCount, ERollout rollout, uint64_t seed)
+    : m_rolloutsPerMove(std::max(rolloutsPerMove, 1)), m_rollout(rollout), m_workers(std::max(threadCount, 1u)), m_nextBatch(0)
+{
+    for (size_t i = 0; i < m_workers.size(); i++) {
+        m_workers[i].random = Hash::mix64(seed + i * 0x9E3779B97F4A7C15ULL) | 1; // independent streams, xorshift state must not be 0
+    }
+    for (unsigned int i = 1; i < m_workers.size(); i++) {
+        m_threads.emplace_back(&MonteCarloPolicy::workerLoop, this, i);
+    }
+}
+
+MonteCarloPolicy::~MonteCarloPolicy() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_startCondition.notify_all();
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+MonteCarloPolicy::Result MonteCarloPolicy::chooseMove(Bitboard::Board board) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    m_root = board;
+    m_moveCount = 0;
+    for (int move = 0; move < 4; move++) {
+        Bitboard::Board moved = Bitboard::move(board, static_cast<Bitboard::EDirection>(move));
+        if (moved == board) continue;
+        m_moved[m_moveCount] = moved;
+        m_moveIndex[m_moveCount++] = move;
+    }
+
+    Result result;
+    if (m_moveCount == 0) return result;
+    if (m_moveCount == 1) { // forced, nothing to compare
+        result.move = m_moveIndex[0];
+        return result;
+    }
+
+    for (Worker& worker : m_workers) {
+        std::fill(worker.scores, worker.scores + 4, 0.0);
+        worker.moves = 0;
+    }
+    m_batchesPerMove = (m_rolloutsPerMove + LANES - 1) / LANES;
+    m_nextBatch = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job++;
+        m_busyThreads = static_cast<unsigned int>(m_threads.size());
+    }
+    m_startCondition.notify_all();
+    runBatches(m_workers[0]);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this] { return m_busyThreads == 0; });
+    }
+
+    double best = 0.0;
+    for (int i = 0; i < m_moveCount; i++) {
+        double total = 0.0;
+        for (const Worker& worker : m_workers) total += worker.scores[i];
+        if (result.move == NO_MOVE || total > best) {
+            best = total;
+            result.move = m_moveIndex[i];
+        }
+    }
+
+    result.score = static_cast<float>(best / m_rolloutsPerMove);
+    result.rollouts = static_cast<uint64_t>(m_rolloutsPerMove) * m_moveCount;
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    m_stats.decisions++;
+    m_stats.rollouts += result.rollouts;
+    for (const Worker& worker : m_workers) m_stats.rolloutMoves += worker.moves;
+    m_stats.seconds += result.milliseconds / 1000.0;
+    return result;
+}
+
+MonteCarloPolicy::Stats MonteCarloPolicy::getStats() const {
+    return m_stats;
+}
+
+void MonteCarloPolicy::workerLoop(unsigned int index) {
+    uint64_t seenJob = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, seenJob] { return m_job != seenJob || m_stopping; });
+            if (m_stopping) return;
+            seenJob = m_job;
+        }
+
+        runBatches(m_workers[index]);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyThreads == 0) m_doneCondition.notify_one();
+    }
+}
+
+void MonteCarloPolicy::runBatches(Worker& worker) {
+    int batchCount = m_batchesPerMove * m_moveCount;
+    for (int batch = m_nextBatch++; batch < batchCount; batch = m_nextBatch++) {
+        int move = batch % m_moveCount;
+        int lanes = std::min(LANES, m_rolloutsPerMove - (batch / m_moveCount) * LANES);
+        worker.scores[move] += playBatch(m_moved[move], lanes, worker);
+    }
+}
+
+double MonteCarloPolicy::playBatch(Bitboard::Board start, int lanes, Worker& worker) {
+    Bitboard::Board boards[LANES];
+    int fourSpawns[LANES];
+    bool alive[LANES];
+    for (int i = 0; i < lanes; i++) {
+        fourSpawns[i] = 0;
+        boards[i] = spawn(start, worker.random, fourSpawns[i]);
+        alive[i] = true;
+    }
+
+    for (int running = lanes; running > 0;) {
+        for (int i = 0; i < lanes; i++) {
+            if (!alive[i]) continue;
+
+            Bitboard::Board moved;
+            pickRolloutMove(boards[i], moved, worker);
+            if (moved == boards[i]) {
+                alive[i] = false;
+                running--;
+                continue;
+            }
+            boards[i] = spawn(moved, worker.random, fourSpawns[i]);
+            worker.moves++;
+        }
+    }
+
+    // the root's own 4s count on both sides, so the difference is what the move and the playout merged;
+    // one rescan per playout costs less than collecting Bitboard::Merges on each of its moves
+    double startScore = static_cast<double>(HeadlessGame::scoreOf(m_root, 0));
+    double total = 0.0;
+    for (int i = 0; i < lanes; i++) {
+        total += static_cast<double>(HeadlessGame::scoreOf(boards[i], fourSpawns[i])) - startScore;
+    }
+    return total;
+}
+
+Bitboard::EDirection MonteCarloPolicy::pickRolloutMove(Bitboard::Board board, Bitboard::Board& moved, Worker& worker) const {
+    if (m_rollout == ERollout::RANDOM && board != 0 && Bitboard::countEmpty(board) > 0) {
+        // uniform over the legal moves by rejection, a direction that changes nothing is drawn again;
+        // a tile next to an empty cell can always move, so the loop ends, usually at the first draw
+        for (uint64_t bits = 0;; bits >>= 2) {
+            if (bits < 4) bits = (nextRandom(worker.random) >> 2) | (static_cast<uint64_t>(1) << 62); // 31 draws, the marker bit ends them
+            Bitboard::EDirection direction = static_cast<Bitboard::EDirection>(bits & 3);
+            moved = Bitboard::move(board, direction);
+            if (moved != board) return direction;
+        }
+    }
+
+    // the candidates are every legal move, or for greedy the ones tied on the most empty cells,
+    // and one of them is drawn uniformly
+    Bitboard::Board candidates[4];
+    int directions[4];
+    int count = 0;
+    int bestEmpty = 0;
+    for (int direction = 0; direction < 4; direction++) {
+        Bitboard::Board candidate = Bitboard::move(board, static_cast<Bitboard::EDirection>(direction));
+        if (candidate == board) continue;
+
+        if (m_rollout == ERollout::GREEDY) {
+            int empty = Bitboard::countEmpty(candidate); // every merge frees a cell
+            if (count > 0 && empty < bestEmpty) continue;
+            if (count == 0 || empty > bestEmpty) count = 0;
+            bestEmpty = empty;
+        }
+        candidates[count] = candidate;
+        directions[count++] = direction;
+    }
+
+    if (count == 0) {
+        moved = board;
+        return Bitboard::EDirection::LEFT;
+    }
+    int chosen = count == 1 ? 0 : static_cast<int>(nextRandom(worker.random) % static_cast<uint64_t>(count));
+    moved = candidates[chosen];
+    return static_cast<Bitboard::EDirection>(directions[chosen]);
+}
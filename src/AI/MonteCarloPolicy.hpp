@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../Game/Bitboard.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Picks the move whose playouts score best on average: every legal move gets the same
+// number of games played to the end with random or greedy moves. A playout batch
+// advances LANES independent boards in lockstep, which keeps the table lookups of
+// several games in flight at once. Batches are shared out to worker threads, each
+// with its own random stream, and the calling thread works along.
+class MonteCarloPolicy {
+public:
+    static const int NO_MOVE = -1;
+
+    enum class ERollout { RANDOM, GREEDY }; // greedy takes the move that merges the most, ties at random
+
+    struct Result {
+        int move = NO_MOVE; // a Bitboard::EDirection, NO_MOVE when the game is over
+        float score = 0.f; // average score gained by the chosen move's playouts
+        uint64_t rollouts = 0;
+        double milliseconds = 0.0;
+    };
+
+    struct Stats {
+        uint64_t decisions = 0;
+        uint64_t rollouts = 0;
+        uint64_t rolloutMoves = 0;
+        double seconds = 0.0;
+
+        double getRolloutsPerSecond() const;
+    };
+
+    MonteCarloPolicy(int rolloutsPerMove, unsigned int threadCount = 1, ERollout rollout = ERollout::RANDOM, uint64_t seed = 1);
+    ~MonteCarloPolicy();
+
+    MonteCarloPolicy(const MonteCarloPolicy&) = delete;
+    MonteCarloPolicy& operator=(const MonteCarloPolicy&) = delete;
+
+    Result chooseMove(Bitboard::Board board); // one caller at a time
+    Stats getStats() const;
+
+private:
+    static const int LANES = 8;
+
+    struct Worker {
+        uint64_t random; // xorshift64* state
+        double scores[4];
+        uint64_t moves;
+        char padding[64]; // keeps neighbouring workers off each other's cache line
+    };
+
+    void workerLoop(unsigned int index);
+    void runBatches(Worker& worker);
+    double playBatch(Bitboard::Board start, int lanes, Worker& worker);
+    Bitboard::EDirection pickRolloutMove(Bitboard::Board board, Bitboard::Board& moved, Worker& worker) const; // moved == board when none is legal
+
+    const int m_rolloutsPerMove;
+    const ERollout m_rollout;
+    std::vector<Worker> m_workers; // [0] belongs to the calling thread
+    Stats m_stats;
+
+    // the current decision, written before the workers start
+    Bitboard::Board m_root = 0;
+    Bitboard::Board m_moved[4];
+    int m_moveIndex[4]; // direction of each legal move
+    int m_moveCount = 0;
+    int m_batchesPerMove = 0;
+    std::atomic<int> m_nextBatch;
+
+    std::mutex m_mutex;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_doneCondition;
+    uint64_t m_job = 0; // guarded by m_mutex
+    unsigned int m_busyThreads = 0;
+    bool m_stopping = false;
+    std::vector<std::thread> m_threads;
+};
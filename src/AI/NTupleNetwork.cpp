@@ -0,0 +1,89 @@
+#include "NTupleNetwork.hpp"
+#include "NTupleWeightFile.hpp"
+#include "../Game/BoardSymmetry.hpp"
+
+#include <algorithm>
+
+const int NTupleNetwork::MAX_TUPLE_SIZE; // std::min takes it by reference
+
+std::vector<NTupleNetwork::Tuple> NTupleNetwork::getDefaultTuples() {
+    // two straight and two boxy shapes, which cover rows, corners and the second row
+    return {
+        { 0, 1, 2, 3, 4, 5 },
+        { 4, 5, 6, 7, 8, 9 },
+        { 0, 1, 2, 4, 5, 6 },
+        { 4, 5, 6, 8, 9, 10 },
+    };
+}
+
+std::vector<NTupleNetwork::Feature> NTupleNetwork::makeFeatures(const std::vector<Tuple>& tuples, size_t& weightCount) {
+    const Bitboard::Board identity = 0xFEDCBA9876543210ULL; // every cell holds its own index
+    std::vector<Feature> features;
+    weightCount = 0;
+    for (const Tuple& tuple : tuples) {
+        int size = std::min(static_cast<int>(tuple.size()), MAX_TUPLE_SIZE);
+        for (int symmetry = 0; symmetry < FEATURES_PER_TUPLE; symmetry++) {
+            Bitboard::Board image = BoardSymmetry::apply(identity, symmetry);
+            Feature feature;
+            feature.offset = weightCount;
+            feature.size = size;
+            for (int k = 0; k < size; k++) {
+                int cell = static_cast<int>((image >> (4 * tuple[k])) & 0xF); // where the cell of the mirrored board comes from
+                feature.shifts[k] = 4 * cell;
+            }
+            features.push_back(feature);
+        }
+        weightCount += static_cast<size_t>(1) << (4 * size);
+    }
+    return features;
+}
+
+NTupleNetwork::NTupleNetwork(const std::vector<Tuple>& tuples) : m_tuples(tuples) {
+    m_features = makeFeatures(m_tuples, m_weightCount);
+    m_weights.reset(new std::atomic<float>[m_weightCount]);
+    for (size_t i = 0; i < m_weightCount; i++) m_weights[i].store(0.f, std::memory_order_relaxed);
+}
+
+float NTupleNetwork::evaluate(Bitboard::Board board) const {
+    float value = 0.f;
+    for (const Feature& feature : m_features) {
+        value += m_weights[feature.getIndex(board)].load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+void NTupleNetwork::adjust(Bitboard::Board board, float delta) {
+    float step = delta / static_cast<float>(m_features.size());
+    for (const Feature& feature : m_features) {
+        std::atomic<float>& weight = m_weights[feature.getIndex(board)];
+        weight.store(weight.load(std::memory_order_relaxed) + step, std::memory_order_relaxed); // not an atomic add, see the class comment
+    }
+}
+
+const std::vector<NTupleNetwork::Tuple>& NTupleNetwork::getTuples() const {
+    return m_tuples;
+}
+
+size_t NTupleNetwork::getWeightCount() const {
+    return m_weightCount;
+}
+
+int NTupleNetwork::getFeatureCount() const {
+    return static_cast<int>(m_features.size());
+}
+
+float NTupleNetwork::getWeight(size_t index) const {
+    return m_weights[index].load(std::memory_order_relaxed);
+}
+
+bool NTupleNetwork::save(const std::string& path) const {
+    return NTupleWeightFile::write(path, *this, NTupleWeightFile::EPrecision::FLOAT32);
+}
+
+bool NTupleNetwork::load(const std::string& path) {
+    NTupleWeightFile file;
+    if (!file.open(path) || file.getTuples() != m_tuples) return false;
+
+    for (size_t i = 0; i < m_weightCount; i++) m_weights[i].store(file.getWeight(i), std::memory_order_relaxed);
+    return true;
+}
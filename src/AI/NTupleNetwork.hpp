@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../Game/Bitboard.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Value of a board as a sum of table lookups: every tuple is a fixed set of cells whose
+// exponents index its own table, read in all eight symmetric positions with one shared
+// table. Weights are atomics accessed relaxed, so self-play threads can update them
+// without locks (Hogwild): concurrent updates to one weight may lose each other, which
+// training tolerates, and on x86 the loads and stores are plain moves.
+class NTupleNetwork {
+public:
+    static const int MAX_TUPLE_SIZE = 6;
+    static const int FEATURES_PER_TUPLE = 8; // one per symmetry
+
+    typedef std::vector<int> Tuple; // cell indices 4 * y + x
+
+    struct Feature { // a tuple in one symmetry
+        size_t offset; // of its tuple's table
+        int size;
+        int shifts[MAX_TUPLE_SIZE]; // bit positions of the cells in this symmetry
+
+        size_t getIndex(Bitboard::Board board) const {
+            size_t index = 0;
+            for (int k = 0; k < size; k++) index |= static_cast<size_t>((board >> shifts[k]) & 0xF) << (4 * k);
+            return offset + index;
+        }
+    };
+
+    static std::vector<Feature> makeFeatures(const std::vector<Tuple>& tuples, size_t& weightCount); // grouped by tuple, in tuple order
+
+    static std::vector<Tuple> getDefaultTuples(); // four 6-tuples, 256 MB of weights
+
+    explicit NTupleNetwork(const std::vector<Tuple>& tuples = getDefaultTuples());
+
+    NTupleNetwork(const NTupleNetwork&) = delete;
+    NTupleNetwork& operator=(const NTupleNetwork&) = delete;
+
+    float evaluate(Bitboard::Board board) const;
+    void adjust(Bitboard::Board board, float delta); // moves the value by about delta, spread over the features
+
+    const std::vector<Tuple>& getTuples() const;
+    size_t getWeightCount() const;
+    int getFeatureCount() const; // tuples times symmetries
+    float getWeight(size_t index) const;
+
+    bool save(const std::string& path) const; // float weights in an NTupleWeightFile, safe to call while training
+    bool load(const std::string& path); // any precision, the tuples must match
+
+private:
+    std::vector<Tuple> m_tuples;
+    std::vector<Feature> m_features;
+    size_t m_weightCount = 0;
+    std::unique_ptr<std::atomic<float>[]> m_weights;
+};
@@ -0,0 +1,311 @@
+#include "NTupleWeightFile.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static const char MAGIC[4] = { 'N', 'T', 'U', 'P' };
+static const size_t DATA_ALIGNMENT = 4096;
+static const uint32_t MAX_TUPLES = 256;
+static const size_t CHUNK = 1 << 20; // weights per write
+static const float INT16_LIMIT = 32767.f;
+static const float FLOAT16_LIMIT = 65504.f; // the largest finite half
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t precision;
+    uint32_t tupleCount;
+    uint64_t weightCount;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+    uint8_t reserved[24];
+};
+
+struct TupleRecord {
+    uint32_t size;
+    float scale; // a stored weight times scale is the weight
+    uint8_t cells[8];
+    uint64_t offset; // of the table, in weights
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(TupleRecord) == 24, "the layout is part of the file format");
+
+static uint16_t toHalf(float value) { // round to nearest even, too large saturates
+    value = std::max(-FLOAT16_LIMIT, std::min(value, FLOAT16_LIMIT));
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent <= 0) { // subnormal or zero
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++; // a carry into the exponent is still right
+    return static_cast<uint16_t>(sign | half);
+}
+
+static float fromHalf(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0) { // zero or subnormal, mantissa * 2^-24
+        float value = static_cast<float>(mantissa) * (1.f / 16777216.f);
+        return sign ? -value : value;
+    }
+    else if (exponent == 31) bits = sign | 0x7F800000 | (mantissa << 13);
+    else bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+const char* NTupleWeightFile::getPrecisionName(EPrecision precision) {
+    switch (precision) {
+    case EPrecision::FLOAT16: return "float16";
+    case EPrecision::INT16: return "int16";
+    default: return "float32";
+    }
+}
+
+bool NTupleWeightFile::parsePrecision(const std::string& name, EPrecision& precision) {
+    for (EPrecision candidate : { EPrecision::FLOAT32, EPrecision::FLOAT16, EPrecision::INT16 }) {
+        if (name == getPrecisionName(candidate)) {
+            precision = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t NTupleWeightFile::getPrecisionBytes(EPrecision precision) {
+    return precision == EPrecision::FLOAT32 ? 4 : 2;
+}
+
+bool NTupleWeightFile::write(const std::string& path, const NTupleNetwork& network, EPrecision precision) {
+    const std::vector<NTupleNetwork::Tuple>& tuples = network.getTuples();
+    size_t weightCount = 0;
+    std::vector<NTupleNetwork::Feature> features = NTupleNetwork::makeFeatures(tuples, weightCount);
+    if (tuples.size() > MAX_TUPLES) return false;
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.precision = static_cast<uint32_t>(precision);
+    header.tupleCount = static_cast<uint32_t>(tuples.size());
+    header.weightCount = weightCount;
+    size_t recordsEnd = sizeof(FileHeader) + tuples.size() * sizeof(TupleRecord);
+    header.dataOffset = (recordsEnd + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+    header.fileSize = header.dataOffset + weightCount * getPrecisionBytes(precision);
+
+    std::vector<TupleRecord> records(tuples.size());
+    for (size_t t = 0; t < tuples.size(); t++) {
+        TupleRecord& record = records[t];
+        record = TupleRecord();
+        record.size = static_cast<uint32_t>(features[t * NTupleNetwork::FEATURES_PER_TUPLE].size);
+        for (uint32_t k = 0; k < record.size; k++) record.cells[k] = static_cast<uint8_t>(tuples[t][k]);
+        record.offset = features[t * NTupleNetwork::FEATURES_PER_TUPLE].offset;
+
+        // the largest weight decides the scale, the rest of the table shares it
+        size_t end = record.offset + (static_cast<size_t>(1) << (4 * record.size));
+        float largest = 0.f;
+        for (size_t i = record.offset; i < end; i++) largest = std::max(largest, std::fabs(network.getWeight(i)));
+        record.scale = 1.f;
+        if (precision == EPrecision::INT16 && largest > 0.f) record.scale = largest / INT16_LIMIT;
+        else if (precision == EPrecision::FLOAT16 && largest > FLOAT16_LIMIT) record.scale = largest / FLOAT16_LIMIT; // halves keep their relative precision at any size
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TupleRecord)));
+        std::vector<char> padding(static_cast<size_t>(header.dataOffset) - recordsEnd, 0);
+        file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+        std::vector<float> floats;
+        std::vector<uint16_t> halves;
+        for (size_t t = 0; t < records.size(); t++) {
+            size_t end = records[t].offset + (static_cast<size_t>(1) << (4 * records[t].size));
+            float inverseScale = 1.f / records[t].scale;
+            for (size_t begin = records[t].offset; begin < end; begin += CHUNK) {
+                size_t chunkEnd = std::min(begin + CHUNK, end);
+                if (precision == EPrecision::FLOAT32) {
+                    floats.resize(chunkEnd - begin);
+                    for (size_t i = begin; i < chunkEnd; i++) floats[i - begin] = network.getWeight(i);
+                    file.write(reinterpret_cast<const char*>(floats.data()), static_cast<std::streamsize>(floats.size() * sizeof(float)));
+                    continue;
+                }
+
+                halves.resize(chunkEnd - begin);
+                for (size_t i = begin; i < chunkEnd; i++) {
+                    float scaled = network.getWeight(i) * inverseScale;
+                    if (precision == EPrecision::FLOAT16) halves[i - begin] = toHalf(scaled);
+                    else halves[i - begin] = static_cast<uint16_t>(static_cast<int16_t>(std::max(-INT16_LIMIT, std::min(std::round(scaled), INT16_LIMIT))));
+                }
+                file.write(reinterpret_cast<const char*>(halves.data()), static_cast<std::streamsize>(halves.size() * sizeof(uint16_t)));
+            }
+        }
+        if (!file.good()) return false;
+    }
+
+    std::remove(path.c_str()); // rename does not replace on Windows
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+NTupleWeightFile::~NTupleWeightFile() {
+    close();
+}
+
+bool NTupleWeightFile::open(const std::string& path) {
+    close();
+    if (!m_file.open(path, true)) return false;
+    size_t fileSize = m_file.getSize();
+
+    const char* bytes = static_cast<const char*>(m_file.getData());
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(bytes);
+    bool valid = fileSize >= sizeof(FileHeader) && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION
+        && header->precision <= static_cast<uint32_t>(EPrecision::INT16) && header->tupleCount <= MAX_TUPLES && header->fileSize == fileSize
+        && header->dataOffset % DATA_ALIGNMENT == 0 && header->dataOffset <= fileSize // the tuple records below must lie inside the mapping
+        && header->dataOffset >= sizeof(FileHeader) + header->tupleCount * sizeof(TupleRecord);
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    m_precision = static_cast<EPrecision>(header->precision);
+    const TupleRecord* records = reinterpret_cast<const TupleRecord*>(bytes + sizeof(FileHeader));
+    for (uint32_t t = 0; t < header->tupleCount; t++) {
+        if (records[t].size == 0 || records[t].size > NTupleNetwork::MAX_TUPLE_SIZE) valid = false;
+        NTupleNetwork::Tuple tuple;
+        for (uint32_t k = 0; k < records[t].size && valid; k++) {
+            if (records[t].cells[k] >= 16) valid = false;
+            tuple.push_back(records[t].cells[k]);
+        }
+        m_tuples.push_back(tuple);
+        m_scales.push_back(records[t].scale);
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    // the tables must sit where NTupleNetwork puts them and fit in the file
+    m_features = NTupleNetwork::makeFeatures(m_tuples, m_weightCount);
+    for (uint32_t t = 0; t < header->tupleCount; t++) {
+        if (records[t].offset != m_features[t * NTupleNetwork::FEATURES_PER_TUPLE].offset) valid = false;
+        m_tableEnds.push_back(static_cast<size_t>(records[t].offset) + (static_cast<size_t>(1) << (4 * records[t].size)));
+    }
+    if (!valid || header->weightCount != m_weightCount || header->dataOffset + m_weightCount * getPrecisionBytes(m_precision) > fileSize) {
+        close();
+        return false;
+    }
+
+    m_data = bytes + header->dataOffset;
+    return true;
+}
+
+void NTupleWeightFile::close() {
+    m_file.close();
+    m_data = nullptr;
+    m_tuples.clear();
+    m_features.clear();
+    m_scales.clear();
+    m_tableEnds.clear();
+    m_weightCount = 0;
+}
+
+bool NTupleWeightFile::isOpen() const {
+    return m_data != nullptr;
+}
+
+float NTupleWeightFile::evaluate(Bitboard::Board board) const {
+    const int perTuple = NTupleNetwork::FEATURES_PER_TUPLE;
+    float value = 0.f;
+    switch (m_precision) {
+    case EPrecision::FLOAT32: {
+        const float* weights = static_cast<const float*>(m_data);
+        for (const NTupleNetwork::Feature& feature : m_features) value += weights[feature.getIndex(board)];
+        break;
+    }
+    case EPrecision::FLOAT16: {
+        const uint16_t* weights = static_cast<const uint16_t*>(m_data);
+        for (size_t t = 0; t < m_scales.size(); t++) {
+            float sum = 0.f;
+            for (int i = 0; i < perTuple; i++) sum += fromHalf(weights[m_features[t * perTuple + i].getIndex(board)]);
+            value += sum * m_scales[t];
+        }
+        break;
+    }
+    case EPrecision::INT16: {
+        const int16_t* weights = static_cast<const int16_t*>(m_data);
+        for (size_t t = 0; t < m_scales.size(); t++) {
+            int32_t sum = 0; // eight int16 values cannot overflow it
+            for (int i = 0; i < perTuple; i++) sum += weights[m_features[t * perTuple + i].getIndex(board)];
+            value += static_cast<float>(sum) * m_scales[t];
+        }
+        break;
+    }
+    }
+    return value;
+}
+
+float NTupleWeightFile::getWeight(size_t index) const {
+    size_t t = static_cast<size_t>(std::upper_bound(m_tableEnds.begin(), m_tableEnds.end(), index) - m_tableEnds.begin());
+    switch (m_precision) {
+    case EPrecision::FLOAT16: return fromHalf(static_cast<const uint16_t*>(m_data)[index]) * m_scales[t];
+    case EPrecision::INT16: return static_cast<float>(static_cast<const int16_t*>(m_data)[index]) * m_scales[t];
+    default: return static_cast<const float*>(m_data)[index];
+    }
+}
+
+int NTupleWeightFile::chooseMove(Bitboard::Board board) const {
+    int best = NO_MOVE;
+    float bestValue = 0.f;
+    for (int move = 0; move < 4; move++) {
+        Bitboard::Merges merges;
+        Bitboard::Board afterstate = Bitboard::move(board, static_cast<Bitboard::EDirection>(move), merges);
+        if (afterstate == board) continue;
+
+        float value = static_cast<float>(merges.score) + evaluate(afterstate);
+        if (best == NO_MOVE || value > bestValue) {
+            best = move;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+
+NTupleWeightFile::EPrecision NTupleWeightFile::getPrecision() const {
+    return m_precision;
+}
+
+const std::vector<NTupleNetwork::Tuple>& NTupleWeightFile::getTuples() const {
+    return m_tuples;
+}
+
+size_t NTupleWeightFile::getWeightCount() const {
+    return m_weightCount;
+}
+
+size_t NTupleWeightFile::getFileSize() const {
+    return m_file.getSize();
+}
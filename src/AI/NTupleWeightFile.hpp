@@ -0,0 +1,59 @@
+#pragma once
+
+#include "NTupleNetwork.hpp"
+#include "../Game/Bitboard.hpp"
+#include "../Utilities/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Trained n-tuple weights in a versioned binary file that is mapped read-only and used in
+// place: opening costs no parsing, and the pages are read in the background or on first
+// touch. Tables are float32, or quantized to float16 or int16 with one scale per table,
+// which halves the memory and cache footprint for a small loss of precision.
+// Little-endian layout: a 64-byte header, a 24-byte record per tuple, then the tables
+// back to back from the next 4096-byte boundary, in NTupleNetwork order.
+class NTupleWeightFile {
+public:
+    static const uint32_t VERSION = 2; // 1 was the trainer's raw float checkpoint
+    static const int NO_MOVE = -1;
+
+    enum class EPrecision { FLOAT32, FLOAT16, INT16 };
+
+    static const char* getPrecisionName(EPrecision precision);
+    static bool parsePrecision(const std::string& name, EPrecision& precision); // "float32", "float16" or "int16"
+    static size_t getPrecisionBytes(EPrecision precision);
+
+    static bool write(const std::string& path, const NTupleNetwork& network, EPrecision precision); // through a temporary file
+
+    NTupleWeightFile() = default;
+    ~NTupleWeightFile();
+
+    NTupleWeightFile(const NTupleWeightFile&) = delete;
+    NTupleWeightFile& operator=(const NTupleWeightFile&) = delete;
+
+    bool open(const std::string& path); // false when missing, damaged or of another version
+    void close();
+    bool isOpen() const;
+
+    float evaluate(Bitboard::Board board) const;
+    float getWeight(size_t index) const; // scaled back to a float
+    int chooseMove(Bitboard::Board board) const; // the largest merge score plus afterstate value, NO_MOVE when the game is over
+
+    EPrecision getPrecision() const;
+    const std::vector<NTupleNetwork::Tuple>& getTuples() const;
+    size_t getWeightCount() const;
+    size_t getFileSize() const;
+
+private:
+    MappedFile m_file;
+    const void* m_data = nullptr; // the first table
+    EPrecision m_precision = EPrecision::FLOAT32;
+    std::vector<NTupleNetwork::Tuple> m_tuples;
+    std::vector<NTupleNetwork::Feature> m_features;
+    std::vector<float> m_scales; // per tuple
+    std::vector<size_t> m_tableEnds; // per tuple, in weights
+    size_t m_weightCount = 0;
+};
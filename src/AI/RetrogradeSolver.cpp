@@ -0,0 +1,334 @@
+#include "RetrogradeSolver.hpp"
+#include "../Utilities/FileSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <queue>
+#include <thread>
+
+static const size_t BLOCK = 4096; // states a thread takes at once
+static const size_t VALUE_BLOCK = 1 << 20; // values computed between two writes in external mode
+static const size_t READ_BUFFER = 1 << 16; // states
+
+static void runOnThreads(unsigned int threads, const std::function<void()>& work) { // the calling thread works too
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; i++) workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers) worker.join();
+}
+
+namespace {
+    class RunReader { // a sorted run from memory or from a file, one state at a time
+        typedef SmallBoard::State State;
+
+    public:
+        explicit RunReader(const std::vector<State>* run) : m_run(run) {}
+        explicit RunReader(const std::string& path) : m_run(nullptr), m_file(path, std::ios::binary) {}
+
+        bool next(State& state) {
+            if (m_position == m_buffered) {
+                if (m_run) {
+                    if (m_buffered == m_run->size()) return false;
+                    m_buffered = m_run->size(); // the run is the buffer
+                }
+                else {
+                    m_buffer.resize(READ_BUFFER);
+                    m_file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(READ_BUFFER * sizeof(State)));
+                    m_buffered = static_cast<size_t>(m_file.gcount()) / sizeof(State);
+                    m_position = 0;
+                    if (m_buffered == 0) return false;
+                }
+            }
+            state = m_run ? (*m_run)[m_position++] : m_buffer[m_position++];
+            return true;
+        }
+
+    private:
+        const std::vector<State>* m_run;
+        std::ifstream m_file;
+        std::vector<State> m_buffer;
+        size_t m_position = 0;
+        size_t m_buffered = 0;
+    };
+}
+
+const RetrogradeSolver::State* RetrogradeSolver::Layer::getStates() const {
+    return stateFile.isOpen() ? static_cast<const State*>(stateFile.getData()) : states.data();
+}
+
+const float* RetrogradeSolver::Layer::getValues() const {
+    return valueFile.isOpen() ? static_cast<const float*>(valueFile.getData()) : values.data();
+}
+
+bool RetrogradeSolver::Layer::findValue(State canonical, float& value) const {
+    const State* begin = getStates();
+    const State* found = std::lower_bound(begin, begin + count, canonical);
+    if (found == begin + count || *found != canonical) return false;
+    value = getValues()[found - begin];
+    return true;
+}
+
+RetrogradeSolver::RetrogradeSolver(const Options& options) : m_options(options), m_board(options.width, options.height),
+    m_bufferStates(std::max<size_t>(1 << 16, (options.memoryMegabytes << 20) / (2 * sizeof(State) * std::max(options.threads, 1u)))) {}
+
+RetrogradeSolver::~RetrogradeSolver() {
+    removeLayerFiles();
+}
+
+bool RetrogradeSolver::solve(const std::string& tablePath, const LayerCallback& onLayer) {
+    typedef std::chrono::steady_clock Clock;
+    bool external = !m_options.workDirectory.empty();
+    if (external && !FileSystem::createDirectories(m_options.workDirectory)) return false;
+
+    // every opening: the first spawn on any cell, the second on any other
+    Clock::time_point start = Clock::now();
+    std::map<uint32_t, std::vector<State>> openings;
+    for (int first = 0; first < m_board.getCellCount(); first++)
+        for (int second = 0; second < m_board.getCellCount(); second++) {
+            if (first == second) continue;
+            for (int a = 1; a <= 2; a++)
+                for (int b = 1; b <= 2; b++) {
+                    State state = SmallBoard::setCell(SmallBoard::setCell(0, first, a), second, b);
+                    openings[SmallBoard::getTileSum(state)].push_back(m_board.canonicalize(state));
+                }
+        }
+    for (auto& opening : openings) addRun(opening.first, opening.second);
+
+    while (!m_pending.empty() && !m_failed) { // a layer is complete once the two below it are expanded
+        Layer* layer = finishLayer(m_pending.begin()->first);
+        if (!layer) break;
+        expandLayer(*layer);
+        if (onLayer) onLayer("forward", layer->tileSum, layer->count);
+    }
+    m_stats.forwardSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    if (m_failed) return false;
+
+    start = Clock::now();
+    for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it) {
+        if (!computeValues(*it->second)) return false;
+        if (onLayer) onLayer("backward", it->first, it->second->count);
+
+        auto done = m_layers.find(it->first + 6); // nothing below reads it any more
+        if (done != m_layers.end()) {
+            done->second->stateFile.close();
+            done->second->valueFile.close();
+        }
+    }
+    m_stats.backwardSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    bool written = writeTable(tablePath);
+    removeLayerFiles();
+    return written;
+}
+
+const RetrogradeSolver::Stats& RetrogradeSolver::getStats() const {
+    return m_stats;
+}
+
+RetrogradeSolver::Layer* RetrogradeSolver::finishLayer(uint32_t tileSum) {
+    Pending pending = std::move(m_pending[tileSum]);
+    m_pending.erase(tileSum);
+
+    std::unique_ptr<Layer> layer(new Layer());
+    layer->tileSum = tileSum;
+    bool external = !m_options.workDirectory.empty();
+
+    if (!external && pending.runs.size() == 1) {
+        layer->states = std::move(pending.runs[0]);
+    }
+    else { // k-way merge, equal states collapse
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const std::vector<State>& run : pending.runs) readers.emplace_back(new RunReader(&run));
+        for (const std::string& path : pending.runFiles) readers.emplace_back(new RunReader(path));
+
+        typedef std::pair<State, size_t> Head; // the next state of a reader
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        for (size_t i = 0; i < readers.size(); i++) {
+            State state;
+            if (readers[i]->next(state)) heads.push(Head(state, i));
+        }
+
+        std::ofstream file;
+        std::vector<State> buffer;
+        if (external) file.open(getLayerPath(tileSum, "states"), std::ios::binary | std::ios::trunc);
+        bool hasLast = false;
+        State last = 0;
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            State state;
+            if (readers[head.second]->next(state)) heads.push(Head(state, head.second));
+            if (hasLast && head.first == last) continue;
+
+            last = head.first;
+            hasLast = true;
+            (external ? buffer : layer->states).push_back(last);
+            if (external && buffer.size() == READ_BUFFER) {
+                file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(State)));
+                layer->count += buffer.size();
+                buffer.clear();
+            }
+        }
+
+        if (external) {
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(State)));
+            layer->count += buffer.size();
+            file.close();
+            if (!file.good() || !layer->stateFile.open(getLayerPath(tileSum, "states"))) m_failed = true;
+        }
+        readers.clear();
+        for (const std::string& path : pending.runFiles) std::remove(path.c_str());
+    }
+    if (!external) layer->count = layer->states.size();
+    if (m_failed) return nullptr;
+
+    m_stats.states += layer->count;
+    m_stats.layers++;
+    m_stats.largestLayer = std::max<uint64_t>(m_stats.largestLayer, layer->count);
+    Layer* result = layer.get();
+    m_layers[tileSum] = std::move(layer);
+    return result;
+}
+
+void RetrogradeSolver::expandLayer(const Layer& layer) {
+    const State* states = layer.getStates();
+    std::atomic<size_t> nextBlock(0);
+    runOnThreads(m_options.threads, [&] {
+        std::vector<State> twos, fours; // successors in the layers two and four higher
+        for (size_t begin = nextBlock.fetch_add(BLOCK); begin < layer.count; begin = nextBlock.fetch_add(BLOCK)) {
+            size_t end = std::min(begin + BLOCK, layer.count);
+            for (size_t i = begin; i < end; i++) {
+                State state = states[i];
+                if (SmallBoard::getMaxExponent(state) >= m_options.target) continue; // won, the game ends here
+
+                for (int direction = 0; direction < 4; direction++) {
+                    State afterstate = m_board.move(state, static_cast<Bitboard::EDirection>(direction));
+                    if (afterstate == state) continue;
+                    for (int cell = 0; cell < m_board.getCellCount(); cell++) {
+                        if (SmallBoard::getCell(afterstate, cell)) continue;
+                        twos.push_back(m_board.canonicalize(SmallBoard::setCell(afterstate, cell, 1)));
+                        fours.push_back(m_board.canonicalize(SmallBoard::setCell(afterstate, cell, 2)));
+                    }
+                }
+            }
+            if (twos.size() >= m_bufferStates) addRun(layer.tileSum + 2, twos);
+            if (fours.size() >= m_bufferStates) addRun(layer.tileSum + 4, fours);
+        }
+        addRun(layer.tileSum + 2, twos);
+        addRun(layer.tileSum + 4, fours);
+    });
+}
+
+void RetrogradeSolver::addRun(uint32_t tileSum, std::vector<State>& run) {
+    if (run.empty()) return;
+    std::sort(run.begin(), run.end());
+    run.erase(std::unique(run.begin(), run.end()), run.end());
+
+    if (m_options.workDirectory.empty()) {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending[tileSum].runs.push_back(std::move(run));
+        run.clear();
+        return;
+    }
+
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        path = m_options.workDirectory + "/run-" + std::to_string(m_runCount++) + ".states";
+        m_stats.spilledRuns++;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(run.data()), static_cast<std::streamsize>(run.size() * sizeof(State)));
+    run.clear();
+
+    std::lock_guard<std::mutex> lock(m_pendingMutex);
+    if (!file.good()) m_failed = true;
+    m_pending[tileSum].runFiles.push_back(path);
+}
+
+bool RetrogradeSolver::computeValues(Layer& layer) {
+    auto two = m_layers.find(layer.tileSum + 2);
+    auto four = m_layers.find(layer.tileSum + 4);
+    const Layer* twoLayer = two != m_layers.end() ? two->second.get() : nullptr;
+    const Layer* fourLayer = four != m_layers.end() ? four->second.get() : nullptr;
+    auto valueOf = [&](State canonical, uint32_t tileSum) {
+        const Layer* next = tileSum == layer.tileSum + 2 ? twoLayer : fourLayer;
+        float value = 0.f;
+        if (next) next->findValue(canonical, value);
+        return value;
+    };
+
+    bool external = !m_options.workDirectory.empty();
+    std::ofstream file;
+    if (external) file.open(getLayerPath(layer.tileSum, "values"), std::ios::binary | std::ios::trunc);
+
+    const State* states = layer.getStates();
+    std::vector<float> values;
+    for (size_t blockBegin = 0; blockBegin < layer.count; blockBegin += VALUE_BLOCK) {
+        size_t blockEnd = std::min(blockBegin + VALUE_BLOCK, layer.count);
+        size_t offset = external ? blockBegin : 0; // memory mode keeps every value
+        values.resize(blockEnd - offset);
+
+        std::atomic<size_t> nextBlock(blockBegin);
+        runOnThreads(m_options.threads, [&] {
+            for (size_t begin = nextBlock.fetch_add(BLOCK); begin < blockEnd; begin = nextBlock.fetch_add(BLOCK)) {
+                for (size_t i = begin; i < std::min(begin + BLOCK, blockEnd); i++) {
+                    State state = states[i];
+                    float best = 0.f; // no move, the game is lost
+                    if (SmallBoard::getMaxExponent(state) >= m_options.target) best = 1.f;
+                    else {
+                        for (int direction = 0; direction < 4; direction++) {
+                            State afterstate = m_board.move(state, static_cast<Bitboard::EDirection>(direction));
+                            if (afterstate != state) best = std::max(best, SolutionTable::getAfterstateValue(m_board, afterstate, valueOf));
+                        }
+                    }
+                    values[i - offset] = best;
+                }
+            }
+        });
+
+        if (external) file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(float)));
+    }
+
+    if (!external) {
+        layer.values = std::move(values);
+        return true;
+    }
+    file.close();
+    return file.good() && layer.valueFile.open(getLayerPath(layer.tileSum, "values"));
+}
+
+bool RetrogradeSolver::writeTable(const std::string& path) {
+    std::vector<SolutionTable::Layer> layers;
+    for (auto& entry : m_layers) {
+        Layer& layer = *entry.second;
+        if (!m_options.workDirectory.empty()) { // mapped again where the backward pass let go
+            if (!layer.stateFile.isOpen() && !layer.stateFile.open(getLayerPath(layer.tileSum, "states"))) return false;
+            if (!layer.valueFile.isOpen() && !layer.valueFile.open(getLayerPath(layer.tileSum, "values"))) return false;
+        }
+        layers.push_back({ layer.tileSum, layer.count, layer.getStates(), layer.getValues() });
+    }
+    return SolutionTable::write(path, m_board, m_options.target, layers);
+}
+
+std::string RetrogradeSolver::getLayerPath(uint32_t tileSum, const char* extension) const {
+    return m_options.workDirectory + "/layer-" + std::to_string(tileSum) + "." + extension;
+}
+
+void RetrogradeSolver::removeLayerFiles() {
+    if (m_options.workDirectory.empty()) return;
+    for (auto& entry : m_layers) {
+        entry.second->stateFile.close();
+        entry.second->valueFile.close();
+        std::remove(getLayerPath(entry.first, "states").c_str());
+        std::remove(getLayerPath(entry.first, "values").c_str());
+    }
+    for (auto& entry : m_pending) {
+        for (const std::string& path : entry.second.runFiles) std::remove(path.c_str());
+    }
+    m_layers.clear();
+    m_pending.clear();
+}
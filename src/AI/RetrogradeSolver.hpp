@@ -0,0 +1,93 @@
+#pragma once
+
+#include "SolutionTable.hpp"
+#include "../Game/SmallBoard.hpp"
+#include "../Utilities/MappedFile.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Solves a small board exactly. A move keeps the tile sum and a spawn adds 2 or 4, so the
+// canonical states fall into layers by tile sum that only lead to higher layers. The
+// forward pass expands layer after layer on all threads, from the opening positions up,
+// and stops at states holding the target tile. The backward pass then takes the layers
+// from the top down: a state is worth 1 with the target tile, otherwise the best move's
+// spawn-weighted average of the next layers, 0 without a move. In external mode each
+// layer is a file that is mapped while it is needed, and successor buffers larger than
+// the memory budget are sorted and spilled as runs, then merged into the next layer.
+class RetrogradeSolver {
+public:
+    struct Options {
+        int width = 3;
+        int height = 3;
+        int target = 9; // exponent of the winning tile
+        unsigned int threads = 1;
+        std::string workDirectory; // external mode when set
+        size_t memoryMegabytes = 1024; // for successor buffers
+    };
+
+    struct Stats {
+        uint64_t states = 0;
+        uint64_t layers = 0;
+        uint64_t largestLayer = 0;
+        uint64_t spilledRuns = 0;
+        double forwardSeconds = 0.0;
+        double backwardSeconds = 0.0;
+    };
+
+    typedef std::function<void(const char* phase, uint32_t tileSum, uint64_t states)> LayerCallback; // after every layer of a pass
+
+    explicit RetrogradeSolver(const Options& options);
+    ~RetrogradeSolver();
+
+    RetrogradeSolver(const RetrogradeSolver&) = delete;
+    RetrogradeSolver& operator=(const RetrogradeSolver&) = delete;
+
+    bool solve(const std::string& tablePath, const LayerCallback& onLayer = nullptr); // false when a file can't be written
+    const Stats& getStats() const;
+
+private:
+    typedef SmallBoard::State State;
+
+    struct Layer {
+        uint32_t tileSum = 0;
+        size_t count = 0;
+        std::vector<State> states; // in memory mode
+        std::vector<float> values;
+        MappedFile stateFile; // in external mode
+        MappedFile valueFile;
+
+        const State* getStates() const;
+        const float* getValues() const;
+        bool findValue(State canonical, float& value) const;
+    };
+
+    struct Pending { // successors of a layer that is not complete yet, as sorted runs without duplicates
+        std::vector<std::vector<State>> runs;
+        std::vector<std::string> runFiles;
+    };
+
+    Layer* finishLayer(uint32_t tileSum); // merges the pending runs
+    void expandLayer(const Layer& layer);
+    void addRun(uint32_t tileSum, std::vector<State>& run); // sorts, drops duplicates and empties run
+    bool computeValues(Layer& layer);
+    bool writeTable(const std::string& path);
+    std::string getLayerPath(uint32_t tileSum, const char* extension) const;
+    void removeLayerFiles();
+
+    const Options m_options;
+    const SmallBoard m_board;
+    const size_t m_bufferStates; // per thread and successor layer, before the buffer becomes a run
+    Stats m_stats;
+    bool m_failed = false;
+
+    std::map<uint32_t, std::unique_ptr<Layer>> m_layers; // by tile sum
+    std::map<uint32_t, Pending> m_pending;
+    std::mutex m_pendingMutex;
+    uint64_t m_runCount = 0; // names the run files
+};
@@ -0,0 +1,186 @@
+#include "SolutionTable.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static const char MAGIC[4] = { 'S', 'O', 'L', 'V' };
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t target;
+    uint32_t layerCount;
+    uint64_t stateCount;
+    uint64_t fileSize;
+    uint8_t reserved[24];
+};
+
+static_assert(sizeof(FileHeader) == 64, "the layout is part of the file format");
+
+bool SolutionTable::write(const std::string& path, const SmallBoard& board, int target, const std::vector<Layer>& layers) {
+    static_assert(sizeof(LayerEntry) == 32, "the layout is part of the file format");
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = static_cast<uint32_t>(board.getWidth());
+    header.height = static_cast<uint32_t>(board.getHeight());
+    header.target = static_cast<uint32_t>(target);
+    header.layerCount = static_cast<uint32_t>(layers.size());
+
+    std::vector<LayerEntry> entries(layers.size());
+    uint64_t offset = sizeof(FileHeader) + layers.size() * sizeof(LayerEntry);
+    for (size_t i = 0; i < layers.size(); i++) {
+        entries[i] = LayerEntry();
+        entries[i].tileSum = layers[i].tileSum;
+        entries[i].count = layers[i].count;
+        entries[i].statesOffset = offset;
+        entries[i].valuesOffset = offset + layers[i].count * sizeof(SmallBoard::State);
+        offset = (entries[i].valuesOffset + layers[i].count * sizeof(float) + 7) / 8 * 8; // the next states stay aligned
+        header.stateCount += layers[i].count;
+    }
+    header.fileSize = offset;
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(LayerEntry)));
+        for (size_t i = 0; i < layers.size(); i++) {
+            file.write(reinterpret_cast<const char*>(layers[i].states), static_cast<std::streamsize>(layers[i].count * sizeof(SmallBoard::State)));
+            file.write(reinterpret_cast<const char*>(layers[i].values), static_cast<std::streamsize>(layers[i].count * sizeof(float)));
+            uint64_t end = entries[i].valuesOffset + layers[i].count * sizeof(float);
+            uint64_t padding = i + 1 < layers.size() ? entries[i + 1].statesOffset - end : header.fileSize - end;
+            file.write("\0\0\0\0\0\0\0", static_cast<std::streamsize>(padding));
+        }
+        if (!file.good()) return false;
+    }
+
+    std::remove(path.c_str()); // rename does not replace on Windows
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool SolutionTable::open(const std::string& path) {
+    close();
+    if (!m_file.open(path)) return false;
+
+    const char* bytes = static_cast<const char*>(m_file.getData());
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(bytes);
+    size_t size = m_file.getSize();
+    bool valid = size >= sizeof(FileHeader) && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION
+        && header->fileSize == size && header->width >= 2 && header->width <= 4 && header->height >= 2 && header->height <= 4
+        && sizeof(FileHeader) + static_cast<uint64_t>(header->layerCount) * sizeof(LayerEntry) <= size;
+
+    const LayerEntry* layers = reinterpret_cast<const LayerEntry*>(bytes + sizeof(FileHeader));
+    for (uint32_t i = 0; valid && i < header->layerCount; i++) {
+        valid = layers[i].statesOffset % 8 == 0 && layers[i].valuesOffset == layers[i].statesOffset + layers[i].count * sizeof(SmallBoard::State)
+            && layers[i].valuesOffset + layers[i].count * sizeof(float) <= size && (i == 0 || layers[i - 1].tileSum < layers[i].tileSum);
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    m_board.reset(new SmallBoard(static_cast<int>(header->width), static_cast<int>(header->height)));
+    m_target = static_cast<int>(header->target);
+    m_stateCount = header->stateCount;
+    m_layers = layers;
+    m_layerCount = header->layerCount;
+    return true;
+}
+
+void SolutionTable::close() {
+    m_file.close();
+    m_board.reset();
+    m_target = 0;
+    m_stateCount = 0;
+    m_layers = nullptr;
+    m_layerCount = 0;
+}
+
+bool SolutionTable::isOpen() const {
+    return m_board != nullptr;
+}
+
+int SolutionTable::getWidth() const {
+    return m_board ? m_board->getWidth() : 0;
+}
+
+int SolutionTable::getHeight() const {
+    return m_board ? m_board->getHeight() : 0;
+}
+
+int SolutionTable::getTarget() const {
+    return m_target;
+}
+
+uint64_t SolutionTable::getStateCount() const {
+    return m_stateCount;
+}
+
+bool SolutionTable::getValue(SmallBoard::State state, float& value) const {
+    if (!m_board) return false;
+    return findValue(m_board->canonicalize(state), SmallBoard::getTileSum(state), value);
+}
+
+int SolutionTable::getBestMove(SmallBoard::State state, float* value) const {
+    if (!m_board) return NO_MOVE;
+
+    int best = NO_MOVE;
+    float bestValue = 0.f;
+    for (int move = 0; move < 4; move++) {
+        SmallBoard::State afterstate = m_board->move(state, static_cast<Bitboard::EDirection>(move));
+        if (afterstate == state) continue;
+
+        float moveValue = getAfterstateValue(*m_board, afterstate, [this](SmallBoard::State canonical, uint32_t tileSum) {
+            float found = 0.f;
+            findValue(canonical, tileSum, found);
+            return found;
+        });
+        if (best == NO_MOVE || moveValue > bestValue) {
+            best = move;
+            bestValue = moveValue;
+        }
+    }
+    if (value) *value = bestValue;
+    return best;
+}
+
+float SolutionTable::getStartValue() const {
+    if (!m_board) return 0.f;
+
+    // the first spawn lands on any of the cells, the second on any other
+    int cells = m_board->getCellCount();
+    float sum = 0.f;
+    for (int first = 0; first < cells; first++)
+        for (int second = 0; second < cells; second++) {
+            if (first == second) continue;
+            for (int a = 1; a <= 2; a++)
+                for (int b = 1; b <= 2; b++) {
+                    float value = 0.f;
+                    getValue(SmallBoard::setCell(SmallBoard::setCell(0, first, a), second, b), value);
+                    sum += (a == 1 ? 0.9f : 0.1f) * (b == 1 ? 0.9f : 0.1f) * value;
+                }
+        }
+    return sum / (cells * (cells - 1));
+}
+
+bool SolutionTable::findValue(SmallBoard::State canonical, uint32_t tileSum, float& value) const {
+    const LayerEntry* layersEnd = m_layers + m_layerCount;
+    const LayerEntry* layer = std::lower_bound(m_layers, layersEnd, tileSum, [](const LayerEntry& entry, uint32_t sum) { return entry.tileSum < sum; });
+    if (layer == layersEnd || layer->tileSum != tileSum) return false;
+
+    const char* bytes = static_cast<const char*>(m_file.getData());
+    const SmallBoard::State* states = reinterpret_cast<const SmallBoard::State*>(bytes + layer->statesOffset);
+    const SmallBoard::State* found = std::lower_bound(states, states + layer->count, canonical);
+    if (found == states + layer->count || *found != canonical) return false;
+
+    value = reinterpret_cast<const float*>(bytes + layer->valuesOffset)[found - states];
+    return true;
+}
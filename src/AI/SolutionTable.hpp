@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Game/SmallBoard.hpp"
+#include "../Utilities/MappedFile.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Exact values of a small board written by RetrogradeSolver: the probability that optimal
+// play reaches the target tile from a canonical state, right after its spawn. The file is
+// mapped read-only. It holds one layer per tile sum, each a sorted array of states and the
+// matching array of values, so a query is a directory lookup and a binary search.
+// Little-endian layout: a 64-byte header, a 32-byte directory entry per layer, the arrays.
+class SolutionTable {
+public:
+    static const uint32_t VERSION = 1;
+    static const int NO_MOVE = -1;
+
+    struct Layer {
+        uint32_t tileSum;
+        size_t count;
+        const SmallBoard::State* states; // sorted
+        const float* values;
+    };
+
+    static bool write(const std::string& path, const SmallBoard& board, int target, const std::vector<Layer>& layers); // layers by rising tile sum
+
+    // averages the values of the states a move can lead to, weighted like the spawns,
+    // valueOf(canonical state, tile sum) is asked for every one
+    template<typename ValueOf>
+    static float getAfterstateValue(const SmallBoard& board, SmallBoard::State afterstate, ValueOf valueOf) {
+        uint32_t tileSum = SmallBoard::getTileSum(afterstate);
+        float sum = 0.f;
+        int empty = 0;
+        for (int cell = 0; cell < board.getCellCount(); cell++) {
+            if (SmallBoard::getCell(afterstate, cell)) continue;
+            sum += 0.9f * valueOf(board.canonicalize(SmallBoard::setCell(afterstate, cell, 1)), tileSum + 2);
+            sum += 0.1f * valueOf(board.canonicalize(SmallBoard::setCell(afterstate, cell, 2)), tileSum + 4);
+            empty++;
+        }
+        return empty ? sum / empty : 0.f;
+    }
+
+    bool open(const std::string& path); // false when missing, damaged or of another version
+    void close();
+    bool isOpen() const;
+
+    int getWidth() const;
+    int getHeight() const;
+    int getTarget() const; // exponent of the winning tile
+    uint64_t getStateCount() const;
+
+    bool getValue(SmallBoard::State state, float& value) const; // false for a state play never reaches
+    int getBestMove(SmallBoard::State state, float* value = nullptr) const; // a Bitboard::EDirection, NO_MOVE when the game is over
+    float getStartValue() const; // before the two opening spawns
+
+private:
+    struct LayerEntry {
+        uint32_t tileSum;
+        uint32_t reserved;
+        uint64_t count;
+        uint64_t statesOffset;
+        uint64_t valuesOffset;
+    };
+
+    MappedFile m_file;
+    std::unique_ptr<SmallBoard> m_board;
+    int m_target = 0;
+    uint64_t m_stateCount = 0;
+    const LayerEntry* m_layers = nullptr;
+    uint32_t m_layerCount = 0;
+
+    bool findValue(SmallBoard::State canonical, uint32_t tileSum, float& value) const;
+};
@@ -0,0 +1,229 @@
+#include "TranspositionTable.hpp"
+#include "../Utilities/Hash.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static const uint64_t VALID_BIT = 1ull << 63; // an all-zero slot is empty
+static const int DEPTH_SHIFT = 32;
+static const int MOVE_SHIFT = 40;
+static const int GENERATION_SHIFT = 48;
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static const size_t OCCUPANCY_SAMPLE = 1024; // buckets
+
+static std::atomic<unsigned int> nextCounterShard(0);
+
+static void* allocatePages(size_t bytes, bool hugePages, bool& gotHugePages) { // zeroed, nullptr on failure
+    gotHugePages = false;
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE); // large pages need a privilege nobody grants
+#else
+#ifdef MAP_HUGETLB
+    if (hugePages && bytes % HUGE_PAGE_SIZE == 0) { // only succeeds when the admin reserved huge pages
+        void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED) {
+            gotHugePages = true;
+            return memory;
+        }
+    }
+#endif
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) return nullptr;
+#ifdef MADV_HUGEPAGE
+    if (hugePages && bytes >= HUGE_PAGE_SIZE) gotHugePages = madvise(memory, bytes, MADV_HUGEPAGE) == 0; // transparent huge pages
+#endif
+    return memory;
+#endif
+}
+
+static void freePages(void* memory, size_t bytes) {
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, bytes);
+#endif
+}
+
+double TranspositionTable::Stats::getHitRate() const {
+    return probes ? static_cast<double>(hits) / probes : 0.0;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes, bool hugePages) : m_generation(0) {
+    size_t requested = std::max<size_t>(megabytes, 1) * 1024 * 1024;
+    m_bucketCount = 1;
+    while (m_bucketCount * 2 * sizeof(Bucket) <= requested) m_bucketCount *= 2;
+
+    for (;;) { // atomics of integral type are trivially constructible, zeroed pages are empty buckets
+        m_bytes = m_bucketCount * sizeof(Bucket);
+        m_buckets = static_cast<Bucket*>(allocatePages(m_bytes, hugePages, m_hugePages));
+        if (m_buckets || m_bucketCount == 1) break;
+        m_bucketCount /= 2;
+    }
+    if (!m_buckets) {
+        std::cerr << "Can't allocate the transposition table" << std::endl;
+        m_bucketCount = 0;
+        m_bytes = 0;
+    }
+    else if (m_bytes < requested / 2) {
+        std::cerr << "Transposition table shrunk to " << (m_bytes >> 20) << " MB, the requested size did not fit" << std::endl;
+    }
+    resetStats();
+}
+
+TranspositionTable::~TranspositionTable() {
+    if (m_buckets) freePages(m_buckets, m_bytes);
+}
+
+bool TranspositionTable::probe(Bitboard::Board board, Entry& entry) {
+    Counters& counter = counters();
+    counter.probes.fetch_add(1, std::memory_order_relaxed);
+    if (!m_bucketCount) return false;
+
+    Bucket& bucket = bucketFor(board);
+    bool occupied = false;
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (!(data & VALID_BIT)) continue;
+
+        if ((check ^ data) == board) {
+            entry = unpack(data);
+            counter.hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        occupied = true;
+    }
+    if (occupied) counter.collisions.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void TranspositionTable::store(Bitboard::Board board, int depth, float score, int move) {
+    if (!m_bucketCount) return;
+
+    Counters& counter = counters();
+    counter.stores.fetch_add(1, std::memory_order_relaxed);
+
+    Bucket& bucket = bucketFor(board);
+    uint64_t data = pack(depth, score, move);
+    Slot& preferred = bucket.slots[0];
+    Slot& always = bucket.slots[1];
+
+    uint64_t oldData = preferred.data.load(std::memory_order_relaxed);
+    uint64_t oldBoard = preferred.check.load(std::memory_order_relaxed) ^ oldData;
+    bool current = (oldData & VALID_BIT) && ((oldData >> GENERATION_SHIFT) & 0xFF) == m_generation.load(std::memory_order_relaxed);
+    Entry old = unpack(oldData);
+
+    Slot* target = &always;
+    if (!current || oldBoard == board || depth >= old.depth) {
+        target = &preferred;
+        if (current && oldBoard != board) { // the evicted result is still worth one more chance
+            always.check.store(oldBoard ^ oldData, std::memory_order_relaxed);
+            always.data.store(oldData, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t targetData = target->data.load(std::memory_order_relaxed);
+    if ((targetData & VALID_BIT) && (target->check.load(std::memory_order_relaxed) ^ targetData) != board) {
+        counter.replacements.fetch_add(1, std::memory_order_relaxed);
+    }
+    target->check.store(board ^ data, std::memory_order_relaxed);
+    target->data.store(data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::newSearch() {
+    m_generation.store(static_cast<uint8_t>(m_generation.load(std::memory_order_relaxed) + 1), std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear(unsigned int threadCount) {
+    if (!m_buckets) return;
+
+    // tens of gigabytes take seconds to zero on one core
+    threadCount = std::max(1u, threadCount);
+    size_t chunk = (m_bytes + threadCount - 1) / threadCount;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        size_t begin = t * chunk;
+        size_t end = std::min(m_bytes, begin + chunk);
+        if (begin >= end) break;
+        workers.emplace_back([this, begin, end] {
+            std::memset(reinterpret_cast<char*>(m_buckets) + begin, 0, end - begin);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+TranspositionTable::Stats TranspositionTable::getStats() const {
+    Stats stats;
+    for (const Counters& counter : m_counters) {
+        stats.probes += counter.probes.load(std::memory_order_relaxed);
+        stats.hits += counter.hits.load(std::memory_order_relaxed);
+        stats.stores += counter.stores.load(std::memory_order_relaxed);
+        stats.collisions += counter.collisions.load(std::memory_order_relaxed);
+        stats.replacements += counter.replacements.load(std::memory_order_relaxed);
+    }
+
+    size_t sample = std::min(m_bucketCount, OCCUPANCY_SAMPLE);
+    size_t used = 0;
+    uint8_t generation = m_generation.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < sample; i++) {
+        for (const Slot& slot : m_buckets[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            if ((data & VALID_BIT) && ((data >> GENERATION_SHIFT) & 0xFF) == generation) used++;
+        }
+    }
+    stats.occupancy = sample ? static_cast<double>(used) / (sample * 2) : 0.0;
+    stats.bytes = m_bytes;
+    stats.hugePages = m_hugePages;
+    return stats;
+}
+
+void TranspositionTable::resetStats() {
+    for (Counters& counter : m_counters) {
+        counter.probes.store(0, std::memory_order_relaxed);
+        counter.hits.store(0, std::memory_order_relaxed);
+        counter.stores.store(0, std::memory_order_relaxed);
+        counter.collisions.store(0, std::memory_order_relaxed);
+        counter.replacements.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t TranspositionTable::getBucketCount() const {
+    return m_bucketCount;
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(Bitboard::Board board) const {
+    return m_buckets[Hash::mix64(board) & (m_bucketCount - 1)]; // boards themselves cluster in the low bits
+}
+
+TranspositionTable::Counters& TranspositionTable::counters() {
+    static thread_local unsigned int shard = nextCounterShard.fetch_add(1, std::memory_order_relaxed) % COUNTER_SHARDS;
+    return m_counters[shard];
+}
+
+uint64_t TranspositionTable::pack(int depth, float score, int move) const {
+    uint32_t scoreBits;
+    std::memcpy(&scoreBits, &score, sizeof(scoreBits));
+    return VALID_BIT | scoreBits
+        | static_cast<uint64_t>(std::min(std::max(depth, 0), 255)) << DEPTH_SHIFT
+        | static_cast<uint64_t>(move & 0x7) << MOVE_SHIFT
+        | static_cast<uint64_t>(m_generation.load(std::memory_order_relaxed)) << GENERATION_SHIFT;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    uint32_t scoreBits = static_cast<uint32_t>(data);
+    Entry entry;
+    std::memcpy(&entry.score, &scoreBits, sizeof(scoreBits));
+    entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+    entry.move = static_cast<int>((data >> MOVE_SHIFT) & 0x7);
+    return entry;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../Game/Bitboard.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size cache of search results shared by any number of threads without locks.
+// Every entry is two 64-bit words, the packed result and the board XOR that result;
+// a probe accepts an entry only if the two still agree, so a store torn by a racing
+// writer reads as a miss instead of a wrong score. A bucket holds a depth-preferred
+// slot, kept while nothing deeper from the current search arrives, and an
+// always-replace slot that takes everything else. The bucket count is the largest
+// power of two that fits the requested size, and the memory asks for huge pages.
+class TranspositionTable {
+public:
+    static const int NO_MOVE = 4; // Bitboard::EDirection values are 0 to 3
+
+    struct Entry {
+        float score;
+        int depth;
+        int move; // NO_MOVE when the search had none
+    };
+
+    struct Stats {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+        uint64_t stores = 0;
+        uint64_t collisions = 0; // probes that found the bucket full of other boards
+        uint64_t replacements = 0; // stores that evicted another board
+        double occupancy = 0.0; // sampled share of slots holding a result of the current search
+        size_t bytes = 0;
+        bool hugePages = false;
+
+        double getHitRate() const;
+    };
+
+    TranspositionTable(size_t megabytes, bool hugePages = true);
+    ~TranspositionTable();
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(Bitboard::Board board, Entry& entry);
+    void store(Bitboard::Board board, int depth, float score, int move = NO_MOVE);
+
+    void newSearch(); // ages everything stored so far, no thread may be storing
+    void clear(unsigned int threadCount = 1); // no thread may be probing or storing
+    Stats getStats() const;
+    void resetStats();
+
+    size_t getBucketCount() const;
+
+private:
+    static const int COUNTER_SHARDS = 16;
+
+    struct Slot {
+        std::atomic<uint64_t> check; // board ^ data
+        std::atomic<uint64_t> data;
+    };
+
+    struct Bucket {
+        Slot slots[2]; // depth-preferred, always-replace
+    };
+
+    struct Counters { // one per shard so threads do not fight over a cache line
+        std::atomic<uint64_t> probes;
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> stores;
+        std::atomic<uint64_t> collisions;
+        std::atomic<uint64_t> replacements;
+        char padding[64 - 5 * sizeof(std::atomic<uint64_t>)];
+    };
+
+    Bucket& bucketFor(Bitboard::Board board) const;
+    Counters& counters();
+    uint64_t pack(int depth, float score, int move) const;
+    static Entry unpack(uint64_t data);
+
+    Bucket* m_buckets = nullptr;
+    size_t m_bucketCount = 0;
+    size_t m_bytes = 0;
+    bool m_mapped = false; // mmap or VirtualAlloc instead of the heap
+    bool m_hugePages = false;
+    std::atomic<uint8_t> m_generation;
+    Counters m_counters[COUNTER_SHARDS];
+};
@@ -0,0 +1,212 @@
+#include "WeightTuner.hpp"
+#include "ExpectimaxSearch.hpp"
+#include "../Game/HeadlessGame.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <thread>
+
+const float WeightTuner::ZERO_SCALE = 50.f;
+const float WeightTuner::STABILITY = 10.f;
+const double WeightTuner::UNLIMITED_BUDGET = 1e9;
+
+static std::string formatWeights(const Heuristic::Weights& weights) { // exact, unlike Weights::toString
+    std::ostringstream stream;
+    stream << std::setprecision(9);
+    for (int i = 0; i < Heuristic::Weights::COUNT; i++) {
+        if (i > 0) stream << ',';
+        stream << Heuristic::Weights::getName(i) << '=' << weights.get(i);
+    }
+    return stream.str();
+}
+
+static double getAverage(const std::vector<uint64_t>& scores) {
+    if (scores.empty()) return 0.0;
+    double sum = 0.0;
+    for (uint64_t score : scores) sum += static_cast<double>(score);
+    return sum / scores.size();
+}
+
+WeightTuner::WeightTuner(const Options& options, const Heuristic::Weights& initial) : m_options(options), m_seed(options.seed),
+    m_initial(initial), m_weights(initial) {
+    for (unsigned int i = 0; i < std::max(options.threads, 1u); i++) {
+        m_tables.emplace_back(new TranspositionTable(std::max<size_t>(options.tableMegabytes, 1)));
+    }
+}
+
+WeightTuner::Iteration WeightTuner::runIteration() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Iteration iteration;
+    iteration.index = m_iterations;
+
+    // every iteration plays seeds of its own, so a resumed run goes on with the same ones
+    uint32_t firstSeed = m_seed + static_cast<uint32_t>(m_iterations) * static_cast<uint32_t>(m_options.gradientGames + m_options.maxGames);
+    std::mt19937 random(m_seed ^ static_cast<uint32_t>(m_iterations) * 2654435761u);
+    float perturbation = m_options.perturbation / std::pow(m_iterations + 1.f, 0.101f);
+    float step = m_options.step / std::pow(m_iterations + 1.f + STABILITY, 0.602f);
+
+    // gradient: the relative score difference along a random direction of all weights
+    std::vector<float> directions(Heuristic::Weights::COUNT, 0.f);
+    Heuristic::Weights plus = m_weights, minus = m_weights;
+    for (int index : m_options.tuned) {
+        directions[index] = random() & 1 ? 1.f : -1.f;
+        float offset = directions[index] * perturbation * getScale(index);
+        plus.set(index, std::max(m_weights.get(index) + offset, 0.f)); // every weight is a magnitude
+        minus.set(index, std::max(m_weights.get(index) - offset, 0.f));
+    }
+    std::vector<uint64_t> plusScores, minusScores;
+    const Heuristic plusHeuristic(plus), minusHeuristic(minus);
+    iteration.moves += playGames(plusHeuristic, &minusHeuristic, firstSeed, m_options.gradientGames, plusScores, minusScores);
+    double plusScore = getAverage(plusScores), minusScore = getAverage(minusScores);
+    iteration.gradient = (plusScore - minusScore) / std::max((plusScore + minusScore) / 2.0, 1.0);
+
+    iteration.candidate = m_weights;
+    for (int index : m_options.tuned) {
+        float change = static_cast<float>(step * iteration.gradient / (2.0 * perturbation)) * directions[index] * getScale(index);
+        iteration.candidate.set(index, std::max(m_weights.get(index) + change, 0.f));
+    }
+
+    // SPRT of the candidate against the incumbent, H0: it wins half the seeds, H1: half plus the margin
+    const double p0 = 0.5, p1 = 0.5 + m_options.margin;
+    const double lower = std::log(m_options.beta / (1.0 - m_options.alpha));
+    const double upper = std::log((1.0 - m_options.beta) / m_options.alpha);
+    const double winRatio = std::log(p1 / p0), lossRatio = std::log((1.0 - p1) / (1.0 - p0));
+
+    const Heuristic candidate(iteration.candidate), incumbent(m_weights);
+    std::vector<uint64_t> candidateScores, incumbentScores;
+    uint32_t testSeed = firstSeed + static_cast<uint32_t>(m_options.gradientGames);
+    while (iteration.gradient != 0.0 && iteration.games < m_options.maxGames) { // without a gradient the candidate is the incumbent
+        int count = std::min(std::max(m_options.batchGames, 1), m_options.maxGames - iteration.games);
+        std::vector<uint64_t> first, second;
+        iteration.moves += playGames(candidate, &incumbent, testSeed + static_cast<uint32_t>(iteration.games), count, first, second);
+        for (int i = 0; i < count; i++) {
+            if (first[i] > second[i]) iteration.wins++;
+            else if (first[i] < second[i]) iteration.losses++; // equal scores are ignored
+        }
+        candidateScores.insert(candidateScores.end(), first.begin(), first.end());
+        incumbentScores.insert(incumbentScores.end(), second.begin(), second.end());
+        iteration.games += count;
+
+        iteration.logLikelihoodRatio = iteration.wins * winRatio + iteration.losses * lossRatio;
+        if (iteration.logLikelihoodRatio <= lower) break;
+        if (iteration.logLikelihoodRatio >= upper) {
+            iteration.accepted = true;
+            break;
+        }
+    }
+    iteration.candidateScore = getAverage(candidateScores);
+    iteration.incumbentScore = getAverage(incumbentScores);
+
+    if (iteration.accepted) {
+        m_weights = iteration.candidate;
+        m_accepted++;
+    }
+    m_iterations++;
+    iteration.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return iteration;
+}
+
+const Heuristic::Weights& WeightTuner::getWeights() const {
+    return m_weights;
+}
+
+int WeightTuner::getIterationCount() const {
+    return m_iterations;
+}
+
+int WeightTuner::getAcceptedCount() const {
+    return m_accepted;
+}
+
+bool WeightTuner::saveCheckpoint(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file << "seed " << m_seed << '\n'
+            << "iterations " << m_iterations << '\n'
+            << "accepted " << m_accepted << '\n'
+            << "initial " << formatWeights(m_initial) << '\n'
+            << "weights " << formatWeights(m_weights) << '\n';
+        if (!file.good()) return false;
+    }
+
+    std::remove(path.c_str()); // rename does not replace on Windows
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool WeightTuner::loadCheckpoint(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    uint32_t seed = 0;
+    int iterations = -1, accepted = -1;
+    Heuristic::Weights initial, weights;
+    bool hasInitial = false, hasWeights = false;
+    std::string key, value;
+    while (file >> key >> value) {
+        if (key == "seed") seed = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (key == "iterations") iterations = std::atoi(value.c_str());
+        else if (key == "accepted") accepted = std::atoi(value.c_str());
+        else if (key == "initial") hasInitial = initial.parse(value);
+        else if (key == "weights") hasWeights = weights.parse(value);
+    }
+    if (iterations < 0 || accepted < 0 || !hasInitial || !hasWeights) return false;
+
+    m_seed = seed;
+    m_iterations = iterations;
+    m_accepted = accepted;
+    m_initial = initial;
+    m_weights = weights;
+    return true;
+}
+
+uint64_t WeightTuner::playGames(const Heuristic& first, const Heuristic* second, uint32_t firstSeed, int count,
+    std::vector<uint64_t>& firstScores, std::vector<uint64_t>& secondScores) {
+    firstScores.assign(count, 0);
+    secondScores.assign(second ? count : 0, 0);
+
+    std::atomic<int> nextGame(0);
+    std::atomic<uint64_t> moves(0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < m_tables.size(); t++) {
+        workers.emplace_back([&, t] {
+            TranspositionTable& table = *m_tables[t];
+            ExpectimaxSearch firstSearch(first, table);
+            std::unique_ptr<ExpectimaxSearch> secondSearch(second ? new ExpectimaxSearch(*second, table) : nullptr);
+
+            uint64_t played = 0;
+            for (int index = nextGame++; index < count; index = nextGame++) {
+                for (int side = 0; side < (second ? 2 : 1); side++) {
+                    // a game must not see what earlier games left in the table, or its result would
+                    // depend on the thread that played it; depth 1 searches never reach the table
+                    if (m_options.depth > 1) table.clear();
+                    ExpectimaxSearch& search = side == 0 ? firstSearch : *secondSearch;
+                    HeadlessGame game(firstSeed + static_cast<uint32_t>(index));
+                    while (!game.isOver()) {
+                        game.play(static_cast<Bitboard::EDirection>(search.search(game.getBoard(), UNLIMITED_BUDGET, m_options.depth).move));
+                    }
+                    (side == 0 ? firstScores : secondScores)[index] = game.getScore();
+                    played += game.getMoves();
+                }
+            }
+            moves += played;
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    return moves;
+}
+
+float WeightTuner::getScale(int index) const {
+    float initial = std::fabs(m_initial.get(index));
+    return initial > 0.f ? initial : ZERO_SCALE;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Heuristic.hpp"
+#include "TranspositionTable.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Tunes the heuristic weights by SPSA on seeded headless games. An iteration perturbs
+// every tuned weight at once in a random direction, plays the same seeds with the two
+// perturbed sets and steps along the relative difference of their average scores. The
+// step only replaces the incumbent if it wins an SPRT against it: both play the same
+// seeds batch by batch, a seed counts as a win or a loss by score, and the test stops
+// once the log-likelihood ratio leaves its bounds, so a clearly worse candidate costs a
+// batch or two. Games use expectimax limited by depth only, which makes them repeat
+// exactly per seed and, at depth 1, take a fraction of a millisecond.
+class WeightTuner {
+public:
+    struct Options {
+        std::vector<int> tuned; // Heuristic::Weights indices
+        unsigned int threads = 1;
+        int depth = 1;
+        uint32_t seed = 1;
+        size_t tableMegabytes = 4; // per thread, cleared before every game
+        int gradientGames = 1000; // per perturbed set
+        int batchGames = 500; // per SPRT step
+        int maxGames = 10000; // per SPRT test, a test still undecided then keeps the incumbent
+        float perturbation = 0.1f; // relative to the weight's scale, shrinks with the iterations
+        float step = 0.2f; // likewise
+        float margin = 0.03f; // H1: the candidate wins this much more than half the seeds, H0: half
+        float alpha = 0.05f; // chance to accept a candidate that is no better
+        float beta = 0.05f; // chance to reject one that is better by the margin
+    };
+
+    struct Iteration {
+        int index = 0;
+        Heuristic::Weights candidate;
+        double gradient = 0.0; // relative score difference of the perturbed sets
+        bool accepted = false;
+        int games = 0; // seeds the SPRT test played, twice each
+        int wins = 0;
+        int losses = 0;
+        double logLikelihoodRatio = 0.0;
+        double incumbentScore = 0.0; // average over the test's seeds
+        double candidateScore = 0.0;
+        uint64_t moves = 0; // of every game in the iteration
+        double seconds = 0.0;
+    };
+
+    WeightTuner(const Options& options, const Heuristic::Weights& initial);
+
+    Iteration runIteration();
+    const Heuristic::Weights& getWeights() const; // the incumbent
+    int getIterationCount() const;
+    int getAcceptedCount() const;
+
+    bool saveCheckpoint(const std::string& path) const;
+    bool loadCheckpoint(const std::string& path); // false when missing or damaged, the tuner is unchanged then
+
+private:
+    static const float ZERO_SCALE; // for weights that start at 0
+    static const float STABILITY; // SPSA's A, damps the first steps
+    static const double UNLIMITED_BUDGET; // milliseconds, the depth ends every search
+
+    // plays seeds firstSeed.. with each heuristic, second may be null
+    uint64_t playGames(const Heuristic& first, const Heuristic* second, uint32_t firstSeed, int count,
+        std::vector<uint64_t>& firstScores, std::vector<uint64_t>& secondScores);
+    float getScale(int index) const;
+
+    const Options m_options;
+    uint32_t m_seed;
+    Heuristic::Weights m_initial; // sets the scales
+    Heuristic::Weights m_weights;
+    int m_iterations = 0;
+    int m_accepted = 0;
+    std::vector<std::unique_ptr<TranspositionTable>> m_tables; // one per thread
+};
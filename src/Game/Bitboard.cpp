@@ -0,0 +1,138 @@
+#include "Bitboard.hpp"
+
+#include <algorithm>
+
+Bitboard::Tables::Tables() {
+    for (uint32_t row = 0; row < 65536; row++) {
+        int line[4];
+        for (int i = 0; i < 4; i++) line[i] = (row >> (4 * i)) & 0xF;
+
+        // slide toward i = 0, each tile merges at most once
+        int result[4] = { 0, 0, 0, 0 };
+        int count = 0;
+        bool canMerge = false;
+        uint32_t mergeScore = 0, mergeCount = 0, mergeMax = 0;
+        for (int i = 0; i < 4; i++) {
+            if (!line[i]) continue;
+            if (canMerge && result[count - 1] == line[i] && line[i] < 15) {
+                result[count - 1]++;
+                canMerge = false;
+                mergeScore += 1u << result[count - 1];
+                mergeCount++;
+                mergeMax = std::max(mergeMax, static_cast<uint32_t>(result[count - 1]));
+            }
+            else {
+                result[count++] = line[i];
+                canMerge = true;
+            }
+        }
+
+        uint16_t left = 0;
+        for (int i = 0; i < 4; i++) left |= result[i] << (4 * i);
+        rowLeft[row] = left;
+        rowMerges[row] = mergeScore | mergeCount << 24 | mergeMax << 28; // a run of equal tiles merges the same pairs from either end
+
+        uint16_t reversedRow = 0;
+        uint16_t reversedLeft = 0;
+        for (int i = 0; i < 4; i++) {
+            reversedRow |= ((row >> (4 * i)) & 0xF) << (4 * (3 - i));
+            reversedLeft |= ((left >> (4 * i)) & 0xF) << (4 * (3 - i));
+        }
+        rowRight[reversedRow] = reversedLeft;
+    }
+}
+
+const Bitboard::Tables& Bitboard::tables() {
+    static const Tables* instance = new Tables(); // built once, thread safe since C++11
+    return *instance;
+}
+
+Bitboard::Board Bitboard::move(Board board, EDirection direction) {
+    const Tables& t = tables();
+    const uint16_t* table = (direction == EDirection::LEFT || direction == EDirection::DOWN) ? t.rowLeft : t.rowRight;
+
+    bool vertical = direction == EDirection::DOWN || direction == EDirection::UP;
+    if (vertical) board = transpose(board);
+
+    Board result = 0;
+    for (int y = 0; y < 4; y++) {
+        result |= static_cast<Board>(table[getRow(board, y)]) << (16 * y);
+    }
+    return vertical ? transpose(result) : result;
+}
+
+Bitboard::Board Bitboard::move(Board board, EDirection direction, Merges& merges) {
+    const Tables& t = tables();
+    Board moved = move(board, direction);
+
+    merges = Merges();
+    if (direction == EDirection::DOWN || direction == EDirection::UP) board = transpose(board);
+    for (int y = 0; y < 4; y++) {
+        uint32_t row = t.rowMerges[getRow(board, y)];
+        merges.score += row & 0xFFFFFF;
+        merges.count += (row >> 24) & 0xF;
+        merges.maxExponent = std::max(merges.maxExponent, static_cast<int>(row >> 28));
+    }
+    return moved;
+}
+
+Bitboard::Board Bitboard::transpose(Board board) {
+    Board a1 = board & 0xF0F00F0FF0F00F0FULL;
+    Board a2 = board & 0x0000F0F00000F0F0ULL;
+    Board a3 = board & 0x0F0F00000F0F0000ULL;
+    Board a = a1 | (a2 << 12) | (a3 >> 12);
+    Board b1 = a & 0xFF00FF0000FF00FFULL;
+    Board b2 = a & 0x00FF00FF00000000ULL;
+    Board b3 = a & 0x00000000FF00FF00ULL;
+    return b1 | (b2 >> 24) | (b3 << 24);
+}
+
+Bitboard::Board Bitboard::spawnTile(Board board, uint32_t random) {
+    int empty = countEmpty(board);
+    if (empty == 0) return board;
+
+    random %= static_cast<uint32_t>(empty) * 10;
+    int target = static_cast<int>(random / 10);
+    Board tile = (random % 10 == 0) ? 2 : 1;
+
+    for (int i = 0; i < 16; i++) {
+        if ((board >> (4 * i)) & 0xF) continue;
+        if (target-- == 0) return board | (tile << (4 * i));
+    }
+    return board;
+}
+
+bool Bitboard::canMove(Board board) {
+    return move(board, EDirection::LEFT) != board || move(board, EDirection::RIGHT) != board
+        || move(board, EDirection::DOWN) != board || move(board, EDirection::UP) != board;
+}
+
+int Bitboard::countEmpty(Board board) {
+    if (board == 0) return 16; // the sum below only has four bits
+    board |= board >> 2; // fold every nibble into its low bit
+    board |= board >> 1;
+    board = ~board & 0x1111111111111111ULL;
+    return static_cast<int>((board * 0x1111111111111111ULL) >> 60); // adds all sixteen nibbles into the top one
+}
+
+int Bitboard::maxExponent(Board board) {
+    int maxExponent = 0;
+    for (int i = 0; i < 16; i++, board >>= 4) {
+        int exponent = static_cast<int>(board & 0xF);
+        if (exponent > maxExponent) maxExponent = exponent;
+    }
+    return maxExponent;
+}
+
+int Bitboard::getCell(Board board, int x, int y) {
+    return static_cast<int>((board >> (4 * (4 * y + x))) & 0xF);
+}
+
+Bitboard::Board Bitboard::setCell(Board board, int x, int y, int exponent) {
+    int shift = 4 * (4 * y + x);
+    return (board & ~(static_cast<Board>(0xF) << shift)) | (static_cast<Board>(exponent & 0xF) << shift);
+}
+
+uint16_t Bitboard::getRow(Board board, int y) {
+    return static_cast<uint16_t>(board >> (16 * y));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// 4x4 board packed into 64 bits: cell (x, y) is the nibble at 4 * (4 * y + x) holding
+// the tile exponent (0 is empty, k is 2^k), y = 0 is the bottom row like Game2048::field.
+// Moves go through precomputed tables for every 16-bit row.
+class Bitboard {
+public:
+    typedef uint64_t Board;
+
+    enum class EDirection { LEFT, RIGHT, DOWN, UP };
+
+    struct Merges { // of one move, so a score needs no rescan of the board
+        uint32_t count = 0;
+        uint32_t score = 0; // sum of the tiles the merges made
+        int maxExponent = 0; // of the largest of them, 0 without merges
+    };
+
+    static Board move(Board board, EDirection direction);
+    static Board move(Board board, EDirection direction, Merges& merges);
+    static Board transpose(Board board); // swaps x and y
+    static Board spawnTile(Board board, uint32_t random); // 2 with 90% chance, 4 otherwise
+    static bool canMove(Board board);
+
+    static int countEmpty(Board board);
+    static int maxExponent(Board board);
+    static int getCell(Board board, int x, int y);
+    static Board setCell(Board board, int x, int y, int exponent);
+
+    static uint16_t getRow(Board board, int y);
+
+private:
+    Bitboard() = delete;
+
+    struct Tables {
+        uint16_t rowLeft[65536];
+        uint16_t rowRight[65536];
+        uint32_t rowMerges[65536]; // score | count << 24 | max exponent << 28, the same sliding either way
+        Tables();
+    };
+
+    static const Tables& tables();
+};
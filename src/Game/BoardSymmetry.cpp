@@ -0,0 +1,60 @@
+#include "BoardSymmetry.hpp"
+
+Bitboard::Board BoardSymmetry::apply(Bitboard::Board board, int symmetry) {
+    if (symmetry & 4) board = Bitboard::transpose(board);
+    if (symmetry & 1) board = flipX(board);
+    if (symmetry & 2) board = flipY(board);
+    return board;
+}
+
+int BoardSymmetry::inverse(int symmetry) {
+    if (!(symmetry & 4)) return symmetry; // the mirrors undo themselves and commute
+    // undoing means mirroring first and transposing last, which turns a mirror in x into one in y
+    return 4 | ((symmetry & 1) << 1) | ((symmetry & 2) >> 1);
+}
+
+Bitboard::EDirection BoardSymmetry::mapDirection(Bitboard::EDirection direction, int symmetry) {
+    bool vertical = direction == Bitboard::EDirection::DOWN || direction == Bitboard::EDirection::UP;
+    bool positive = direction == Bitboard::EDirection::RIGHT || direction == Bitboard::EDirection::UP;
+
+    if (symmetry & 4) vertical = !vertical;
+    if ((symmetry & 1) && !vertical) positive = !positive;
+    if ((symmetry & 2) && vertical) positive = !positive;
+
+    if (vertical) return positive ? Bitboard::EDirection::UP : Bitboard::EDirection::DOWN;
+    return positive ? Bitboard::EDirection::RIGHT : Bitboard::EDirection::LEFT;
+}
+
+Bitboard::Board BoardSymmetry::canonicalize(Bitboard::Board board) {
+    int symmetry;
+    return canonicalize(board, symmetry);
+}
+
+Bitboard::Board BoardSymmetry::canonicalize(Bitboard::Board board, int& symmetry) {
+    Bitboard::Board transposed = Bitboard::transpose(board);
+    Bitboard::Board images[COUNT];
+    images[0] = board;
+    images[1] = flipX(board);
+    images[2] = flipY(board);
+    images[3] = flipY(images[1]);
+    images[4] = transposed;
+    images[5] = flipX(transposed);
+    images[6] = flipY(transposed);
+    images[7] = flipY(images[5]);
+
+    symmetry = 0;
+    for (int s = 1; s < COUNT; s++) {
+        if (images[s] < images[symmetry]) symmetry = s;
+    }
+    return images[symmetry];
+}
+
+Bitboard::Board BoardSymmetry::flipX(Bitboard::Board board) {
+    return ((board & 0x000F000F000F000FULL) << 12) | ((board & 0x00F000F000F000F0ULL) << 4)
+        | ((board >> 4) & 0x00F000F000F000F0ULL) | ((board >> 12) & 0x000F000F000F000FULL);
+}
+
+Bitboard::Board BoardSymmetry::flipY(Bitboard::Board board) {
+    return (board << 48) | ((board << 16) & 0x0000FFFF00000000ULL)
+        | ((board >> 16) & 0x00000000FFFF0000ULL) | (board >> 48);
+}
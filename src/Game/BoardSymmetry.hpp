@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Bitboard.hpp"
+
+// The eight rotations and reflections of a 4x4 board. Symmetry s transposes when
+// bit 2 is set, then mirrors x when bit 0 is set and y when bit 1 is set, so s = 0 is
+// the identity. The rules commute with all of them once moves are remapped too:
+// apply(move(b, d), s) == move(apply(b, s), mapDirection(d, s)). Caches and datasets
+// keyed on canonical boards store one entry for up to eight positions.
+class BoardSymmetry {
+public:
+    static const int COUNT = 8;
+
+    static Bitboard::Board apply(Bitboard::Board board, int symmetry);
+    static int inverse(int symmetry);
+    static Bitboard::EDirection mapDirection(Bitboard::EDirection direction, int symmetry);
+
+    static Bitboard::Board canonicalize(Bitboard::Board board); // the smallest of the eight images
+    static Bitboard::Board canonicalize(Bitboard::Board board, int& symmetry); // also which symmetry produced it
+
+    static Bitboard::Board flipX(Bitboard::Board board); // x becomes 3 - x
+    static Bitboard::Board flipY(Bitboard::Board board); // y becomes 3 - y
+
+private:
+    BoardSymmetry() = delete;
+};
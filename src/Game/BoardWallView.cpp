@@ -0,0 +1,80 @@
+#include "BoardWallView.hpp"
+
+#include <string>
+
+static const glm::vec4 BOARD_COLOR(0.73f, 0.68f, 0.63f, 1.f);
+
+BoardWallView::BoardWallView(GLFWwindow* _window, size_t width, size_t height, size_t boardCount, unsigned int threadCount, unsigned int movesPerSecond, FramePacer& framePacer)
+    : window(_window), m_windowWidth(width), m_windowHeight(height), m_framePacer(framePacer), m_farm(boardCount, threadCount, movesPerSecond), m_boards(boardCount)
+{
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, keysCallback);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+
+    m_cellTexture = ResourceManager::loadTexture("res/textures/cells.png");
+    m_wallShaderProg = ResourceManager::loadShaderProgram("res/shaders/vWall.txt", "res/shaders/fWall.txt");
+}
+
+void BoardWallView::run() {
+    while (!glfwWindowShouldClose(window)) {
+        if (!m_resourcesLoaded) {
+            showLoadingScreen();
+            continue;
+        }
+
+        showWall();
+        Renderer::captureFrame(m_windowWidth, m_windowHeight);
+        glfwSwapBuffers(window);
+        m_framePacer.frameFinished();
+        glfwPollEvents();
+        updateTitle();
+    }
+}
+
+void BoardWallView::showLoadingScreen() {
+    if (ResourceManager::update()) {
+        m_renderer.reset(new BoardWallRenderer(m_farm.getBoardCount(), m_cellTexture, m_wallShaderProg));
+        m_resourcesLoaded = true;
+    }
+
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+    glfwSwapBuffers(window);
+    m_framePacer.frameFinished();
+    glfwPollEvents();
+}
+
+void BoardWallView::showWall() {
+    m_farm.readBoards(m_boards.data());
+
+    Renderer::viewport(0, 0, m_windowWidth, m_windowHeight);
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+    m_renderer->render(m_boards.data(), m_windowWidth, m_windowHeight);
+}
+
+void BoardWallView::updateTitle() {
+    double now = glfwGetTime();
+    if (now - m_lastTitleUpdate < 1.0) return;
+
+    uint64_t moves = m_farm.getMovesPlayed();
+    std::string title = "2048 - " + std::to_string(m_farm.getBoardCount()) + " boards, "
+        + std::to_string(static_cast<uint64_t>((moves - m_lastMovesPlayed) / (now - m_lastTitleUpdate))) + " moves/s, "
+        + std::to_string(m_farm.getGamesFinished()) + " games finished";
+    glfwSetWindowTitle(window, title.c_str());
+
+    m_lastTitleUpdate = now;
+    m_lastMovesPlayed = moves;
+}
+
+void BoardWallView::keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+}
+
+void BoardWallView::framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    BoardWallView* view = static_cast<BoardWallView*>(glfwGetWindowUserPointer(window));
+    if (width <= 0 || height <= 0) return;
+
+    view->m_windowWidth = width;
+    view->m_windowHeight = height;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <memory>
+#include <vector>
+#include "SelfPlayFarm.hpp"
+#include "../Graphics/BoardWallRenderer.hpp"
+#include "../Graphics/FramePacer.hpp"
+
+// Monitoring view: every game of a SelfPlayFarm as a thumbnail, redrawn each frame.
+class BoardWallView {
+    GLFWwindow* window;
+    size_t m_windowWidth; // framebuffer size in pixels
+    size_t m_windowHeight;
+
+    FramePacer& m_framePacer;
+    SelfPlayFarm m_farm;
+    std::vector<Bitboard::Board> m_boards;
+    std::unique_ptr<BoardWallRenderer> m_renderer;
+    TextureHandle m_cellTexture;
+    ShaderProgramHandle m_wallShaderProg;
+
+    bool m_resourcesLoaded = false;
+    double m_lastTitleUpdate = 0.0;
+    uint64_t m_lastMovesPlayed = 0;
+
+    void showLoadingScreen();
+    void showWall();
+    void updateTitle();
+
+    static void keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+
+public:
+    BoardWallView(GLFWwindow* _window, size_t width, size_t height, size_t boardCount, unsigned int threadCount, unsigned int movesPerSecond, FramePacer& framePacer);
+    void run();
+};
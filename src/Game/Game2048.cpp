@@ -1,195 +1,485 @@
 #include "Game2048.hpp"
 
-Game2048::Game2048(GLFWwindow* _window, size_t width, size_t height) : window(_window), m_windowWidth(width), m_windowHeight(height) {
+static const glm::vec4 BOARD_COLOR(0.73f, 0.68f, 0.63f, 1.f);
+static const glm::vec4 HUD_TEXT_COLOR(0.47f, 0.43f, 0.40f, 1.f);
+static const glm::vec4 TILE_LABEL_COLOR(0.98f, 0.96f, 0.94f, 1.f);
+static const glm::vec4 HINT_COLOR(1.f, 1.f, 1.f, 0.8f);
+static const uint8_t LAST_ATLAS_EXPONENT = 15; // cells.png ends at 32768, larger tiles are blank and get a text label
+
+static AnimatedTileRenderer::Tile makeTile(int from, int to, uint32_t count) { // cells as y * width + x
+    AnimatedTileRenderer::Tile tile;
+    tile.from = static_cast<uint8_t>(from);
+    tile.to = static_cast<uint8_t>(to);
+    tile.exponent = 0;
+    while (count >>= 1) tile.exponent++;
+    tile.unused = 0;
+    return tile;
+}
+
+Game2048::Game2048(GLFWwindow* _window, size_t width, size_t height, FramePacer& framePacer, const std::string& nTupleWeights, const std::string& solutionTable) : window(_window), m_framePacer(framePacer), m_windowWidth(width), m_windowHeight(height),
+    m_framebufferSize(0), m_resizePending(false), m_refreshPending(false), m_stopping(false) {
     glfwSetWindowUserPointer(window, this);
     glfwSetKeyCallback(window, keysCallback);
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
     srand(std::time(NULL));
 
+    m_hintEngine.reset(new HintEngine([this] { // a deeper hint needs a frame even if the board did not change
+        m_refreshPending = true;
+        wakeRenderer();
+    }));
+    if (!nTupleWeights.empty() && !m_nTuples.open(nTupleWeights)) {
+        std::cerr << "Can't map n-tuple weights: " << nTupleWeights << std::endl;
+    }
+    if (!solutionTable.empty()) {
+        if (!m_solution.open(solutionTable)) std::cerr << "Can't map the solution table: " << solutionTable << std::endl;
+        else if (m_solution.getWidth() != FIELD_WIDTH || m_solution.getHeight() != FIELD_HEIGHT) {
+            std::cerr << "The solution table is for a " << m_solution.getWidth() << "x" << m_solution.getHeight() << " board, the game plays on "
+                << FIELD_WIDTH << "x" << FIELD_HEIGHT << std::endl;
+            m_solution.close();
+        }
+    }
     loadResources();
     fieldInit();
+    publishSnapshot();
+    m_dirty = false;
 }
 
 void Game2048::run() {
+    glfwMakeContextCurrent(NULL); // the render thread owns the context until it exits
+    m_logicThread = std::thread(&Game2048::logicLoop, this);
+    m_renderThread = std::thread(&Game2048::renderLoop, this);
+
     while (!glfwWindowShouldClose(window)) {
-        update();
+        glfwWaitEvents(); // callbacks only queue work for the other threads
+    }
 
-        showGame();
+    stopThreads();
+    glfwMakeContextCurrent(window); // sprites and resources are released on this thread
+}
 
-        glfwSwapBuffers(window);
+void Game2048::stopThreads() {
+    {
+        std::lock_guard<std::mutex> inputLock(m_inputMutex);
+        std::lock_guard<std::mutex> renderLock(m_renderMutex);
+        m_stopping = true;
     }
+    m_inputCondition.notify_one();
+    m_renderCondition.notify_one();
+
+    m_logicThread.join();
+    m_renderThread.join();
+    m_hintEngine.reset();
 }
 
-void Game2048::update() {
-    if (m_currentAnimation == EAnimations::NONE) {
-        if (shouldNewCellBeGenerated) generateNewCell();
-        glfwPollEvents();
+void Game2048::logicLoop() {
+    const std::chrono::nanoseconds tick(1000000000 / TICK_RATE);
+    std::chrono::steady_clock::time_point nextTick = std::chrono::steady_clock::now();
+
+    while (!m_stopping) {
+        advanceAnimation();
+        if (m_currentAnimation == EAnimations::NONE) { // input waits until the tiles have settled
+            if (shouldNewCellBeGenerated) generateNewCell();
+            processInput();
+            if (m_autoplay != EAutoplay::OFF && m_currentAnimation == EAnimations::NONE && !shouldNewCellBeGenerated) playAutoMove();
+        }
+
+        if (m_dirty) {
+            publishSnapshot();
+            m_dirty = false;
+        }
+
+        if (m_currentAnimation != EAnimations::NONE || shouldNewCellBeGenerated || m_autoplay != EAutoplay::OFF) {
+            nextTick += tick;
+            std::this_thread::sleep_until(nextTick);
+        }
+        else {
+            waitForInput(); // nothing moves, sleep until a key arrives
+            nextTick = std::chrono::steady_clock::now();
+        }
     }
 }
 
-void Game2048::loadResources() {
-    cellWidthAndHeight = FlexibleSizes::getSize(m_windowWidth, FIELD_WIDTH);
+void Game2048::processInput() {
+    std::deque<InputEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        events.swap(m_inputEvents);
+    }
 
-    std::shared_ptr<Texture> cellTexture = std::make_shared<Texture>("res/textures/cells.png");
-    cellShaderProg = std::make_shared<ShaderProgram>("res/shaders/vSprite.txt", "res/shaders/fSprite.txt");
-    for (size_t i = 0, j = 0; j < texCoords.size(); i <<= 1, j++) {
-        cellSpriteMap[i] = std::make_shared<Sprite>(cellTexture, cellShaderProg, glm::vec2(0.f), glm::vec2(cellWidthAndHeight), 0.f, texCoords[j]);
-        if (i == 0) i++;
+    for (const InputEvent& event : events) {
+        handleKey(event.key, event.action);
     }
+}
 
-    cellShaderProg->use();
-    cellShaderProg->setInt("tex", 0);
+void Game2048::waitForInput() {
+    std::unique_lock<std::mutex> lock(m_inputMutex);
+    m_inputCondition.wait(lock, [this] { return !m_inputEvents.empty() || m_stopping; });
+}
+
+void Game2048::advanceAnimation() {
+    if (m_currentAnimation == EAnimations::NONE) return;
 
-    glm::mat4 projectionMatrix = glm::ortho(0.f, static_cast<float>(m_windowWidth), 0.f, static_cast<float>(m_windowHeight), -1.f, 1.f);
-    cellShaderProg->setMatrix4("projectionMat", projectionMatrix);
+    m_animationTime += 1.f / TICK_RATE;
+    if (m_animationTime * ANIMATION_SPEED > FIELD_WIDTH - 1) { // every tile has reached its cell
+        m_currentAnimation = EAnimations::NONE;
+        m_animationTime = 0.f;
+    }
+    m_dirty = true;
 }
 
-void Game2048::fieldInit() {
-    m_currentAnimation = EAnimations::NONE;
+void Game2048::publishSnapshot() {
+    std::vector<AnimatedTileRenderer::Tile> tiles;
+    collectTiles(tiles);
+    if (tiles.size() != m_tiles.size() || !std::equal(tiles.begin(), tiles.end(), m_tiles.begin(), [](const AnimatedTileRenderer::Tile& a, const AnimatedTileRenderer::Tile& b) {
+        return a.from == b.from && a.to == b.to && a.exponent == b.exponent;
+    })) {
+        m_tiles.swap(tiles);
+        m_tilesVersion++;
+    }
 
-    field.clear();
-    field.resize(FIELD_HEIGHT);
-    for (size_t i = 0; i < FIELD_HEIGHT; i++) {
-        field[i].resize(FIELD_WIDTH);
+    Snapshot& snapshot = m_snapshots.writeBuffer();
+    if (snapshot.tilesVersion != m_tilesVersion) { // the slot may still hold an older list
+        std::copy(m_tiles.begin(), m_tiles.end(), snapshot.tiles);
+        snapshot.tileCount = static_cast<int>(m_tiles.size());
+        snapshot.tilesVersion = m_tilesVersion;
     }
+    snapshot.animationTime = m_animationTime;
+    snapshot.stats = m_statsTracker.getStats();
+    snapshot.hintPosition = m_hintPosition;
 
-    generateNewCell();
-    generateNewCell();
-    savePreviousFieldState();
+    m_snapshots.publish();
+    wakeRenderer();
 }
 
-void Game2048::showGame() {
-    for (size_t j = 0; j < FIELD_HEIGHT; j++) // empty field
-        for (size_t i = 0; i < FIELD_WIDTH; i++) {
-            cellSpriteMap[0]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-            cellSpriteMap[0]->render();
+void Game2048::collectTiles(std::vector<AnimatedTileRenderer::Tile>& tiles) const {
+    bool moving = m_currentAnimation != EAnimations::NONE;
+    if (moving) tiles = m_mergedAwayTiles;
+
+    for (int y = 0; y < FIELD_HEIGHT; y++)
+        for (int x = 0; x < FIELD_WIDTH; x++) {
+            const Cell& cell = field[x][y];
+            if (!cell.have_count) continue;
+
+            int cellIndex = y * FIELD_WIDTH + x;
+            if (!moving) tiles.push_back(makeTile(cellIndex, cellIndex, cell.count));
+            else tiles.push_back(makeTile(cell.originY * FIELD_WIDTH + cell.originX, cellIndex, cell.merged ? cell.count >> 1 : cell.count)); // shown as it was until the tiles land
         }
+}
 
-    for (size_t j = 0; j < FIELD_HEIGHT; j++) {
-        for (size_t i = 0; i < FIELD_WIDTH; i++) {
-            if (m_currentAnimation == EAnimations::NONE && field[j][i].have_count) {
-                cellSpriteMap[field[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-                cellSpriteMap[field[j][i].count]->render();
-            }
-            else {
-                static float k = 0.f;
-                int l;
-                switch (m_currentAnimation) {
-                case EAnimations::LEFT:
-                    if (previousFieldState[j][i].have_count) animationLeft(j, i, k);
-                    break;
-
-                case EAnimations::RIGHT:
-                    if (previousFieldState[j][i].have_count) animationRight(j, i, k);
-                    break;
-
-                case EAnimations::DOWN:
-                    if (previousFieldState[j][i].have_count) animationDown(j, i, k);
-                    break;
-
-                case EAnimations::UP:
-                    if (previousFieldState[j][i].have_count) animationUp(j, i, k);
-                    break;
-                }
-                if (previousFieldState[j][i].have_count)
-                    cellSpriteMap[previousFieldState[j][i].count]->render();
-            }
+void Game2048::wakeRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(m_renderMutex);
+        m_renderWork = true;
+    }
+    m_renderCondition.notify_one();
+}
+
+void Game2048::waitForRenderWork() {
+    std::unique_lock<std::mutex> lock(m_renderMutex);
+    m_renderCondition.wait(lock, [this] { return m_renderWork || m_stopping; });
+    m_renderWork = false;
+}
+
+void Game2048::renderLoop() {
+    glfwMakeContextCurrent(window);
+    m_framePacer.applySwapInterval();
+
+    while (!m_stopping) {
+        applyPendingResize();
+
+        if (!m_resourcesLoaded) {
+            showLoadingScreen();
+            continue;
         }
+
+        bool changed = m_snapshots.consume();
+        if (m_refreshPending.exchange(false)) changed = true;
+
+        if (!changed) {
+            m_frameStats.skippedFrames++;
+            m_framePacer.pause();
+            waitForRenderWork();
+            continue;
+        }
+
+        showGame(m_snapshots.readBuffer());
+        Renderer::captureFrame(m_windowWidth, m_windowHeight);
+        glfwSwapBuffers(window);
+        m_framePacer.frameFinished();
+        m_frameStats.renderedFrames++;
     }
+
+    glfwMakeContextCurrent(NULL);
 }
 
-void Game2048::animationLeft(int j, int i, float& k) {
-    if (j == 0 || (j > 0 && previousFieldState[j - 1][i].have_count && previousFieldState[j - 1][i].count != previousFieldState[j][i].count)) {
-        cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-        return;
+void Game2048::applyPendingResize() {
+    if (!m_resizePending.exchange(false)) return;
+
+    uint64_t size = m_framebufferSize.load();
+    m_windowWidth = size_t(size >> 32);
+    m_windowHeight = size_t(size & 0xFFFFFFFFu);
+    if (m_resourcesLoaded) {
+        updateLayout();
+        m_refreshPending = true;
     }
-    else if (k <= (FIELD_WIDTH - 1) * cellWidthAndHeight) {
-        int x = j;
-        while (j > 0 && x >= 0 && field[x][i].count != previousFieldState[j][i].count && field[x][i].count != previousFieldState[j][i].count << 1) {
-            x--;
+}
+
+const Game2048::FrameStats& Game2048::getFrameStats() const {
+    return m_frameStats;
+}
+
+const GameStats& Game2048::getGameStats() const {
+    return m_statsTracker.getStats();
+}
+
+const Game2048::AutoplayStats& Game2048::getAutoplayStats() const {
+    return m_autoplayStats;
+}
+
+Bitboard::Board Game2048::getBitboard() const {
+    Bitboard::Board board = 0;
+    for (int y = 0; y < FIELD_HEIGHT; y++)
+        for (int x = 0; x < FIELD_WIDTH; x++) {
+            if (!field[x][y].have_count) continue;
+            int exponent = 0;
+            for (uint32_t count = field[x][y].count; count > 1; count >>= 1) exponent++;
+            board = Bitboard::setCell(board, x, y, std::min(exponent, 15)); // a nibble per cell, larger tiles play like 32768
         }
-        if (k > (j - x) * cellWidthAndHeight) {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight - (j - x) * cellWidthAndHeight, i * cellWidthAndHeight));
+    return board;
+}
+
+void Game2048::cycleAutoplay() {
+    switch (m_autoplay) {
+    case EAutoplay::OFF:
+        m_autoplay = EAutoplay::EXPECTIMAX;
+        if (!m_search) {
+            m_heuristic.reset(new Heuristic());
+            m_searchTable.reset(new TranspositionTable(SEARCH_TABLE_MEGABYTES));
+            m_search.reset(new ExpectimaxSearch(*m_heuristic, *m_searchTable));
         }
-        else {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight - k, i * cellWidthAndHeight));
+        break;
+    case EAutoplay::EXPECTIMAX:
+        m_autoplay = EAutoplay::MONTE_CARLO;
+        if (!m_monteCarlo) { // half the cores, the other half keep the render and hint threads going
+            unsigned int threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+            m_monteCarlo.reset(new MonteCarloPolicy(AUTOPLAY_ROLLOUTS, threads, MonteCarloPolicy::ERollout::RANDOM, static_cast<uint64_t>(time(nullptr))));
         }
-        k += 2.f;
+        break;
+    case EAutoplay::MONTE_CARLO:
+        m_autoplay = m_nTuples.isOpen() ? EAutoplay::N_TUPLE : m_solution.isOpen() ? EAutoplay::EXACT : EAutoplay::OFF;
+        break;
+    case EAutoplay::N_TUPLE:
+        m_autoplay = m_solution.isOpen() ? EAutoplay::EXACT : EAutoplay::OFF;
+        break;
+    case EAutoplay::EXACT:
+        m_autoplay = EAutoplay::OFF;
+        break;
+    }
+}
+
+void Game2048::requestHint() {
+    if (!m_hints) return;
+
+    if (++m_lastHintPosition == 0) m_lastHintPosition = 1; // 0 means no hint
+    m_hintPosition = m_lastHintPosition;
+    m_hintEngine->analyse(getBitboard(), m_hintPosition);
+    m_dirty = true;
+}
+
+void Game2048::dropHint() {
+    if (m_hintPosition == 0) return;
+
+    m_hintEngine->cancel();
+    m_hintPosition = 0;
+    m_dirty = true;
+}
+
+void Game2048::playAutoMove() {
+    int move = ExpectimaxSearch::NO_MOVE;
+    if (gameOver) {}
+    else if (m_autoplay == EAutoplay::MONTE_CARLO) {
+        MonteCarloPolicy::Result result = m_monteCarlo->chooseMove(getBitboard());
+        move = result.move;
+        m_autoplayStats.monteCarloMoves++;
+        m_autoplayStats.rollouts += result.rollouts;
+        m_autoplayStats.monteCarloMilliseconds += result.milliseconds;
+    }
+    else if (m_autoplay == EAutoplay::N_TUPLE) {
+        move = m_nTuples.chooseMove(getBitboard());
+        m_autoplayStats.nTupleMoves++;
+    }
+    else if (m_autoplay == EAutoplay::EXACT) { // the bitboard is the table's state, both use a nibble per cell in row order
+        move = m_solution.getBestMove(getBitboard());
+        m_autoplayStats.exactMoves++;
     }
     else {
-        m_currentAnimation = EAnimations::NONE;
-        k = 0.f;
+        ExpectimaxSearch::Result result = m_search->search(getBitboard(), AUTOPLAY_BUDGET);
+        move = result.move;
+        m_autoplayStats.moves++;
+        m_autoplayStats.depth += result.depth;
+        m_autoplayStats.nodes += result.nodes;
+        m_autoplayStats.milliseconds += result.milliseconds;
     }
+    if (move == ExpectimaxSearch::NO_MOVE) { // stop on the final board instead of starting over
+        m_autoplay = EAutoplay::OFF;
+        return;
+    }
+
+    static const int keys[4] = { GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_DOWN, GLFW_KEY_UP }; // Bitboard::EDirection order
+    handleKey(keys[move], GLFW_PRESS);
 }
 
-void Game2048::animationRight(int j, int i, float& k) {
-    if (j == FIELD_WIDTH - 1 || (j < FIELD_WIDTH - 1 && previousFieldState[j + 1][i].have_count && previousFieldState[j + 1][i].count != previousFieldState[j][i].count)) {
-        cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-        return;
+void Game2048::loadResources() {
+    cellTexture = ResourceManager::loadTexture("res/textures/cells.png");
+    cellShaderProg = ResourceManager::loadShaderProgram("res/shaders/vSprite.txt", "res/shaders/fSprite.txt");
+    m_tileShaderProg = ResourceManager::loadShaderProgram("res/shaders/vTiles.txt", "res/shaders/fBoard.txt");
+    m_textShaderProg = ResourceManager::loadShaderProgram("res/shaders/vText.txt", "res/shaders/fText.txt");
+}
+
+void Game2048::showLoadingScreen() {
+    if (ResourceManager::update()) {
+        createSprites();
+        m_resourcesLoaded = true;
     }
-    else if (k <= (FIELD_WIDTH - 1) * cellWidthAndHeight) {
-        int x = j;
-        while (j < FIELD_WIDTH - 1 && x < FIELD_WIDTH && field[x][i].count != previousFieldState[j][i].count && field[x][i].count != previousFieldState[j][i].count << 1) {
-            x++;
-        }
-        if (k > (x - j) * cellWidthAndHeight) {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight + (x - j) * cellWidthAndHeight, i * cellWidthAndHeight));
-        }
-        else {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight + k, i * cellWidthAndHeight));
-        }
-        k += 2.f;
+
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+    glfwSwapBuffers(window);
+    m_framePacer.frameFinished();
+}
+
+void Game2048::createSprites() {
+    m_emptyCellSprite.reset(new Sprite(cellTexture, cellShaderProg, glm::vec2(0.f), glm::vec2(cellWidthAndHeight), 0.f, emptyCellTexCoords));
+    m_tileRenderer.reset(new AnimatedTileRenderer(FIELD_WIDTH, MAX_TILES, ANIMATION_SPEED, cellTexture, m_tileShaderProg));
+    m_textRenderer.reset(new TextRenderer(m_textShaderProg));
+
+    ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(cellShaderProg);
+    shaderProgram->use();
+    shaderProgram->setInt("tex", 0);
+
+    updateLayout();
+}
+
+void Game2048::updateLayout() { // framebuffer pixels drive everything, so HiDPI needs no extra scaling
+    // half a cell above the board is left for the score line
+    cellWidthAndHeight = std::min(FlexibleSizes::getSize(m_windowWidth, FIELD_WIDTH), FlexibleSizes::getSize(m_windowHeight * 2, FIELD_HEIGHT * 2 + 1));
+    m_boardOffset = glm::vec2((m_windowWidth - cellWidthAndHeight * FIELD_WIDTH) / 2, (m_windowHeight - cellWidthAndHeight * FIELD_HEIGHT - cellWidthAndHeight / 2) / 2);
+
+    m_emptyCellSprite->setSize(glm::vec2(cellWidthAndHeight));
+
+    // the board is centered by the projection, cell positions stay in board space
+    m_projectionMatrix = glm::ortho(-m_boardOffset.x, m_windowWidth - m_boardOffset.x, -m_boardOffset.y, m_windowHeight - m_boardOffset.y, -1.f, 1.f);
+    ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(cellShaderProg);
+    shaderProgram->use();
+    shaderProgram->setMatrix4("projectionMat", m_projectionMatrix);
+
+    createBackground();
+
+    Renderer::viewport(0, 0, m_windowWidth, m_windowHeight);
+    m_hudText.clear(); // laid out for the old size
+}
+
+void Game2048::createBackground() {
+    if (!m_backgroundFBO) {
+        m_backgroundTexture = ResourceManager::createTexture(m_windowWidth, m_windowHeight);
+        m_backgroundFBO.reset(new FBO());
+        m_backgroundSprite.reset(new Sprite(m_backgroundTexture, cellShaderProg, -m_boardOffset, glm::vec2(m_windowWidth, m_windowHeight)));
     }
     else {
-        m_currentAnimation = EAnimations::NONE;
-        k = 0.f;
+        ResourceManager::resizeTexture(m_backgroundTexture, m_windowWidth, m_windowHeight);
+        m_backgroundSprite->setPosition(-m_boardOffset);
+        m_backgroundSprite->setSize(glm::vec2(m_windowWidth, m_windowHeight));
     }
-}
 
-void Game2048::animationDown(int j, int i, float& k) {
-    if (i == 0 || (i > 0 && previousFieldState[j][i - 1].have_count && previousFieldState[j][i - 1].count != previousFieldState[j][i].count)) {
-        cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-        return;
+    if (!m_backgroundFBO->attachTexture(*ResourceManager::getTexture(m_backgroundTexture))) {
+        std::cerr << "Background framebuffer is incomplete" << std::endl;
     }
-    else if (k <= (FIELD_HEIGHT - 1) * cellWidthAndHeight) {
-        int x = i;
-        while (i > 0 && x >= 0 && field[j][x].count != previousFieldState[j][i].count && field[j][x].count != previousFieldState[j][i].count << 1) {
-            x--;
-        }
-        if (k > (i - x) * cellWidthAndHeight) {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight - (i - x) * cellWidthAndHeight));
-        }
-        else {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight - k));
+
+    FBO::bind(m_backgroundFBO->getID());
+    Renderer::viewport(0, 0, m_windowWidth, m_windowHeight);
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+
+    for (size_t j = 0; j < FIELD_HEIGHT; j++) // empty field
+        for (size_t i = 0; i < FIELD_WIDTH; i++) {
+            m_emptyCellSprite->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
+            m_emptyCellSprite->render();
         }
-        k += 2.f;
+
+    FBO::unbind();
+}
+
+void Game2048::fieldInit() {
+    m_currentAnimation = EAnimations::NONE;
+
+    field.clear();
+    field.resize(FIELD_HEIGHT);
+    for (size_t i = 0; i < FIELD_HEIGHT; i++) {
+        field[i].resize(FIELD_WIDTH);
     }
-    else {
-        m_currentAnimation = EAnimations::NONE;
-        k = 0.f;
+    m_statsTracker.reset();
+
+    generateNewCell();
+    generateNewCell();
+    savePreviousFieldState();
+}
+
+void Game2048::showGame(const Snapshot& state) {
+    m_backgroundSprite->render(); // empty field, drawn once into a texture by createBackground()
+
+    if (state.tilesVersion != m_uploadedTilesVersion) { // a move, a new tile or an undo; animation frames upload nothing
+        m_tileRenderer->upload(state.tiles, state.tileCount);
+        m_uploadedTilesVersion = state.tilesVersion;
     }
+    m_tileRenderer->render(m_projectionMatrix, static_cast<float>(cellWidthAndHeight), state.animationTime);
+
+    updateText(state);
+    m_textRenderer->render(m_projectionMatrix, state.animationTime, ANIMATION_SPEED * cellWidthAndHeight); // labels slide with their tiles
 }
 
-void Game2048::animationUp(int j, int i, float& k) {
-    if (i == FIELD_HEIGHT - 1 || (i < FIELD_HEIGHT - 1 && previousFieldState[j][i + 1].have_count && previousFieldState[j][i + 1].count != previousFieldState[j][i].count)) {
-        cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight));
-        return;
+void Game2048::updateText(const Snapshot& state) {
+    std::string score = "SCORE " + std::to_string(state.stats.score);
+    std::string progress = "BEST " + std::to_string(state.stats.maxTile) + "  MOVES " + std::to_string(state.stats.moves);
+    HintEngine::Hint hint = m_hintEngine->getHint();
+    int hintMove = state.hintPosition != 0 && hint.position == state.hintPosition ? hint.move : ExpectimaxSearch::NO_MOVE;
+    if (score + '|' + progress == m_hudText && state.tilesVersion == m_textTilesVersion && hintMove == m_textHintMove) return; // unchanged, the batch is already uploaded
+    m_hudText = score + '|' + progress;
+    m_textTilesVersion = state.tilesVersion;
+    m_textHintMove = hintMove;
+
+    float cell = static_cast<float>(cellWidthAndHeight);
+    float height = cell / 4;
+    float baseline = cell * FIELD_HEIGHT + (cell / 2 - height) / 2;
+    m_textRenderer->clear();
+    m_textRenderer->addText(score, glm::vec2(cell / 8, baseline), height, HUD_TEXT_COLOR);
+    m_textRenderer->addText(progress, glm::vec2(cell * FIELD_WIDTH - cell / 8 - m_textRenderer->measure(progress, height), baseline), height, HUD_TEXT_COLOR);
+
+    for (int i = 0; i < state.tileCount; i++) {
+        const AnimatedTileRenderer::Tile& tile = state.tiles[i];
+        if (tile.exponent <= LAST_ATLAS_EXPONENT) continue;
+
+        std::string label = std::to_string(uint64_t(1) << tile.exponent);
+        float labelHeight = std::min(cell * 0.3f, cell * 0.85f / m_textRenderer->measure(label, 1.f)); // long numbers shrink to fit the tile
+        glm::vec2 from(tile.from % FIELD_WIDTH, tile.from / FIELD_WIDTH);
+        glm::vec2 to(tile.to % FIELD_WIDTH, tile.to / FIELD_WIDTH);
+        glm::vec2 position = (to + 0.5f) * cell - glm::vec2(m_textRenderer->measure(label, labelHeight), labelHeight) * 0.5f;
+        m_textRenderer->addText(label, position, labelHeight, TILE_LABEL_COLOR, (to - from) * cell);
     }
-    else if (k <= (FIELD_HEIGHT - 1) * cellWidthAndHeight) {
-        int x = i;
-        while (i < FIELD_HEIGHT - 1 && x < FIELD_HEIGHT && field[j][x].count != previousFieldState[j][i].count && field[j][x].count != previousFieldState[j][i].count << 1) {
-            x++;
-        }
-        if (k > (x - i) * cellWidthAndHeight) {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight + (x - i) * cellWidthAndHeight));
-        }
-        else {
-            cellSpriteMap[previousFieldState[j][i].count]->setPosition(glm::vec2(j * cellWidthAndHeight, i * cellWidthAndHeight + k));
+
+    if (hintMove != ExpectimaxSearch::NO_MOVE) { // an arrow at the board edge the suggested move pushes toward
+        static const char* const arrows[4] = { "<", ">", "V", "^" }; // Bitboard::EDirection order
+        float arrowHeight = cell * 0.6f;
+        float margin = cell * 0.15f;
+        glm::vec2 size(m_textRenderer->measure(arrows[hintMove], arrowHeight), arrowHeight);
+        glm::vec2 position = (glm::vec2(FIELD_WIDTH, FIELD_HEIGHT) * cell - size) * 0.5f;
+        switch (static_cast<Bitboard::EDirection>(hintMove)) {
+        case Bitboard::EDirection::LEFT:  position.x = margin; break;
+        case Bitboard::EDirection::RIGHT: position.x = cell * FIELD_WIDTH - margin - size.x; break;
+        case Bitboard::EDirection::DOWN:  position.y = margin; break;
+        case Bitboard::EDirection::UP:    position.y = cell * FIELD_HEIGHT - margin - size.y; break;
         }
-        k += 2.f;
-    }
-    else {
-        m_currentAnimation = EAnimations::NONE;
-        k = 0.f;
+        m_textRenderer->addText(arrows[hintMove], position, arrowHeight, HINT_COLOR);
     }
 }
 
@@ -214,19 +504,28 @@ void Game2048::generateNewCell() {
             field[x][y].have_count = true;
             if (rand() % 10 + 1 < 10) field[x][y].count = 2;
             else field[x][y].count = 4;
+            m_statsTracker.onSpawn(field[x][y].count);
         }
     }
     shouldNewCellBeGenerated = false;
     NumberOfUsedCells = getNumberOfUsedCells();
+    m_dirty = true;
+    requestHint();
 }
 
 void Game2048::savePreviousFieldState() {
     previousFieldState = field;
+    m_previousStats = m_statsTracker.getStats();
 }
 
 void Game2048::loadPreviousFieldState() {
     gameOver = false;
     std::swap(field, previousFieldState);
+    GameStats current = m_statsTracker.getStats();
+    m_statsTracker.restore(m_previousStats);
+    m_previousStats = current;
+    m_dirty = true;
+    requestHint();
 }
 
 bool Game2048::areThereAnyPossibleMoves() {
@@ -265,18 +564,44 @@ void Game2048::restartGame() {
 
 void Game2048::keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     Game2048* game = static_cast<Game2048*>(glfwGetWindowUserPointer(window));
-    game->handleKey(key, action);
+    {
+        std::lock_guard<std::mutex> lock(game->m_inputMutex);
+        game->m_inputEvents.push_back({ key, action });
+    }
+    game->m_inputCondition.notify_one();
+}
+
+void Game2048::framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    Game2048* game = static_cast<Game2048*>(glfwGetWindowUserPointer(window));
+    game->handleResize(width, height);
+}
+
+void Game2048::handleResize(int width, int height) {
+    if (width <= 0 || height <= 0) return; // minimized
+
+    m_framebufferSize = uint64_t(width) << 32 | uint64_t(height);
+    m_resizePending = true;
+    wakeRenderer();
+}
+
+void Game2048::windowRefreshCallback(GLFWwindow* window) {
+    Game2048* game = static_cast<Game2048*>(glfwGetWindowUserPointer(window));
+    game->m_refreshPending = true;
+    game->wakeRenderer();
 }
 
 void Game2048::handleKey(int key, int action) {
     shouldNewCellBeGenerated = false;
     shouldFieldStateBeSaved = true;
 
+    bool arrowPressed = (key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT || key == GLFW_KEY_UP || key == GLFW_KEY_DOWN) && action == GLFW_PRESS && !gameOver;
+    if (arrowPressed) beginMove();
+
     if (key == GLFW_KEY_LEFT && action == GLFW_PRESS && !gameOver) { // left
         for (size_t j = 0; j < FIELD_HEIGHT; j++)
             for (size_t i = 0; i < FIELD_WIDTH; i++)
                 if (field[i][j].have_count) {
-                    int count = field[i][j].count;
+                    uint32_t count = field[i][j].count;
                     moveCell(i, j, -1, 0);
                     std::pair<int, int> new_position = getNewCellPosition(i, j, key, count);
                     mergeCells(new_position.first, new_position.second, 1, 0);
@@ -286,7 +611,7 @@ void Game2048::handleKey(int key, int action) {
         for (size_t j = 0; j < FIELD_HEIGHT; j++)
             for (int i = FIELD_WIDTH - 1; i >= 0; i--)
                 if (field[i][j].have_count) {
-                    int count = field[i][j].count;
+                    uint32_t count = field[i][j].count;
                     moveCell(i, j, 1, 0);
                     std::pair<int, int> new_position = getNewCellPosition(i, j, key, count);
                     mergeCells(new_position.first, new_position.second, -1, 0);
@@ -296,7 +621,7 @@ void Game2048::handleKey(int key, int action) {
         for (int j = FIELD_HEIGHT - 1; j >= 0; j--)
             for (size_t i = 0; i < FIELD_WIDTH; i++)
                 if (field[i][j].have_count) {
-                    int count = field[i][j].count;
+                    uint32_t count = field[i][j].count;
                     moveCell(i, j, 0, 1);
                     std::pair<int, int> new_position = getNewCellPosition(i, j, key, count);
                     mergeCells(new_position.first, new_position.second, 0, -1);
@@ -306,16 +631,27 @@ void Game2048::handleKey(int key, int action) {
         for (size_t j = 0; j < FIELD_HEIGHT; j++)
             for (size_t i = 0; i < FIELD_WIDTH; i++)
                 if (field[i][j].have_count) {
-                    int count = field[i][j].count;
+                    uint32_t count = field[i][j].count;
                     moveCell(i, j, 0, -1);
                     std::pair<int, int> new_position = getNewCellPosition(i, j, key, count);
                     mergeCells(new_position.first, new_position.second, 0, 1);
                 }
     }
+    else if (key == GLFW_KEY_A && action == GLFW_PRESS) {
+        cycleAutoplay();
+    }
+    else if (key == GLFW_KEY_H && action == GLFW_PRESS) {
+        m_hints = !m_hints;
+        if (m_hints) requestHint();
+        else dropHint();
+    }
     else if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
+        glfwPostEmptyEvent(); // wake the main thread out of glfwWaitEvents
     }
 
+    bool moved = arrowPressed && shouldNewCellBeGenerated; // only moveCell and mergeCells set it
+
     if (key == GLFW_KEY_LEFT_CONTROL || key == GLFW_KEY_RIGHT_CONTROL) {
         ctrlPressed = (action != GLFW_RELEASE);
     }
@@ -326,6 +662,9 @@ void Game2048::handleKey(int key, int action) {
         loadPreviousFieldState();
     }
 
+    if (moved) m_statsTracker.onMove(); // not by the animation, later keys of the batch still see it
+    if (m_currentAnimation != EAnimations::NONE) m_dirty = true;
+
     if (!areThereAnyPossibleMoves()) gameOver = true;
 
     if (gameOver && (key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT || key == GLFW_KEY_UP || key == GLFW_KEY_DOWN) && action == GLFW_PRESS) {
@@ -333,6 +672,17 @@ void Game2048::handleKey(int key, int action) {
     }
 }
 
+void Game2048::beginMove() {
+    dropHint(); // the analysed board is gone
+    m_mergedAwayTiles.clear();
+    for (int x = 0; x < FIELD_WIDTH; x++)
+        for (int y = 0; y < FIELD_HEIGHT; y++) {
+            field[x][y].originX = x;
+            field[x][y].originY = y;
+            field[x][y].merged = false;
+        }
+}
+
 void Game2048::moveCell(int x, int y, int dx, int dy) {
     if (x + dx >= 0 && x + dx < FIELD_WIDTH && y + dy >= 0 && y + dy < FIELD_HEIGHT && !field[x + dx][y + dy].have_count) {
         if (shouldFieldStateBeSaved) { // save #1
@@ -349,7 +699,7 @@ void Game2048::moveCell(int x, int y, int dx, int dy) {
     }
 }
 
-std::pair<int, int> Game2048::getNewCellPosition(int x, int y, int key, int count) {
+std::pair<int, int> Game2048::getNewCellPosition(int x, int y, int key, uint32_t count) {
     while (x >= 0 && x < FIELD_WIDTH && y >= 0 && y < FIELD_HEIGHT && field[x][y].count != count) {
         if (key == GLFW_KEY_LEFT) x--;
         else if (key == GLFW_KEY_RIGHT) x++;
@@ -366,7 +716,12 @@ void Game2048::mergeCells(int x, int y, int dx, int dy) {
                 savePreviousFieldState();
                 shouldFieldStateBeSaved = false;
             }
+            const Cell& mergedAway = field[x + dx][y + dy];
+            m_mergedAwayTiles.push_back(makeTile(mergedAway.originY * FIELD_WIDTH + mergedAway.originX, y * FIELD_WIDTH + x, mergedAway.count));
+
             field[x][y].count <<= 1;
+            field[x][y].merged = true;
+            m_statsTracker.onMerge(field[x][y].count);
             field[x + dx][y + dy].count = 0;
             field[x + dx][y + dy].have_count = false;
             shouldNewCellBeGenerated = true;
@@ -2,72 +2,165 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <time.h>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
-#include <unordered_map>
 #include "../Graphics/Sprite.hpp"
+#include "../Graphics/FBO.hpp"
+#include "../Graphics/AnimatedTileRenderer.hpp"
+#include "../Graphics/TextRenderer.hpp"
+#include "../Graphics/FramePacer.hpp"
+#include "../AI/ExpectimaxSearch.hpp"
+#include "../AI/HintEngine.hpp"
+#include "../AI/MonteCarloPolicy.hpp"
+#include "../AI/NTupleWeightFile.hpp"
+#include "../AI/SolutionTable.hpp"
+#include "../Resources/ResourceManager.hpp"
 #include "../Utilities/FlexibleSizes.hpp"
+#include "../Utilities/TripleBuffer.hpp"
+#include "GameStats.hpp"
 
+// Three threads share the game: the main thread only pumps GLFW events into an input
+// queue, the logic thread runs moves and animation at a fixed tick and publishes
+// snapshots, the render thread owns the GL context and draws the latest snapshot.
 class Game2048 {
     GLFWwindow* window;
-    const size_t m_windowWidth;
-    const size_t m_windowHeight;
+    FramePacer& m_framePacer; // render thread
+    size_t m_windowWidth; // framebuffer size in pixels, render thread
+    size_t m_windowHeight;
 
     static const int FIELD_WIDTH = 4;
     static const int FIELD_HEIGHT = 4;
+    static const int TICK_RATE = 120; // logic ticks per second while something moves
+    static constexpr float ANIMATION_SPEED = 24.f; // cells per second
+    static const int MAX_TILES = 2 * FIELD_WIDTH * FIELD_HEIGHT; // every cell, plus the tiles merged away by a move
+    static constexpr double AUTOPLAY_BUDGET = 5.0; // milliseconds of search per move
+    static const size_t SEARCH_TABLE_MEGABYTES = 64;
+    static const int AUTOPLAY_ROLLOUTS = 200; // per legal move
 
     struct Cell {
         bool have_count;
-        int count;
+        uint32_t count; // up to 2^31
+        int originX, originY; // where the tile stood before the current move
+        bool merged; // doubled by the current move
+    };
+
+    enum class EAnimations { RIGHT, LEFT, DOWN, UP, NONE };
+    enum class EAutoplay { OFF, EXPECTIMAX, MONTE_CARLO, N_TUPLE, EXACT }; // the order A cycles through, N_TUPLE only with weights, EXACT with a table
+
+    struct Snapshot { // everything a frame needs, copied out of the logic thread's state
+        AnimatedTileRenderer::Tile tiles[MAX_TILES];
+        int tileCount;
+        uint64_t tilesVersion; // changes once per move, not per animation tick
+        float animationTime; // seconds since the move started
+        GameStats stats;
+        uint32_t hintPosition; // the HintEngine position matching this board, 0 when no hint applies
+    };
+
+    struct InputEvent {
+        int key;
+        int action;
     };
  
     std::vector<std::vector<Cell>> field;
     std::vector<std::vector<Cell>> previousFieldState; // for CTRL + Z
 
-    std::array<std::array<GLfloat, 8>, 16> texCoords = { {
-        {0.0f, 0.75f,   0.25f, 0.75f,   0.25f, 1.0f,   0.0f, 1.0f}, // empty cell
-        {0.25f, 0.75f,   0.5f, 0.75f,   0.5f, 1.0f,   0.25f, 1.0f}, // 2
-        {0.5f, 0.75f,   0.75f, 0.75f,   0.75f, 1.0f,   0.5f, 1.0f}, // 4
-        {0.75f, 0.75f,   1.0f, 0.75f,   1.0f, 1.0f,   0.75f, 1.0f}, // 8
-
-        {0.0f, 0.5f,   0.25f, 0.5f,   0.25f, 0.75f,   0.0f, 0.75f}, // 16
-        {0.25f, 0.5f,   0.5f, 0.5f,   0.5f, 0.75f,   0.25f, 0.75f}, // 32
-        {0.5f, 0.5f,   0.75f, 0.5f,   0.75f, 0.75f,   0.5f, 0.75f}, // 64
-        {0.75f, 0.5f,   1.0f, 0.5f,   1.0f, 0.75f,   0.75f, 0.75f}, // 128
-
-        {0.0f, 0.25f,   0.25f, 0.25f,   0.25f, 0.5f,   0.0f, 0.5f}, // 256
-        {0.25f, 0.25f,   0.5f, 0.25f,   0.5f, 0.5f,   0.25f, 0.5f}, // 512
-        {0.5f, 0.25f,   0.75f, 0.25f,   0.75f, 0.5f,   0.5f, 0.5f}, // 1024
-        {0.75f, 0.25f,   1.0f, 0.25f,   1.0f, 0.5f,   0.75f, 0.5f}, // 2048
-
-        {0.0f, 0.0f,   0.25f, 0.0f,   0.25f, 0.25f,   0.0f, 0.25f}, // 4096
-        {0.25f, 0.0f,   0.5f, 0.0f,   0.5f, 0.25f,   0.25f, 0.25f}, // 8192
-        {0.5f, 0.0f,   0.75f, 0.0f,   0.75f, 0.25f,   0.5f, 0.25f}, // 16384
-        {0.75f, 0.0f,   1.0f, 0.0f,   1.0f, 0.25f,   0.75f, 0.25f} // 32768
-    } };
-    std::unordered_map<int, std::shared_ptr<Sprite>> cellSpriteMap;
-    std::shared_ptr<ShaderProgram> cellShaderProg;
+    std::array<GLfloat, 8> emptyCellTexCoords = { 0.0f, 0.75f,   0.25f, 0.75f,   0.25f, 1.0f,   0.0f, 1.0f };
+    std::unique_ptr<Sprite> m_emptyCellSprite;
+    std::unique_ptr<AnimatedTileRenderer> m_tileRenderer;
+    TextureHandle cellTexture;
+    ShaderProgramHandle cellShaderProg;
+    ShaderProgramHandle m_tileShaderProg;
+    ShaderProgramHandle m_textShaderProg;
+    std::unique_ptr<TextRenderer> m_textRenderer;
+    std::string m_hudText; // what the text batch currently holds, along with the labels of m_textTilesVersion
+    uint64_t m_textTilesVersion = 0;
+    int m_textHintMove = ExpectimaxSearch::NO_MOVE;
     size_t cellWidthAndHeight;
+    glm::vec2 m_boardOffset;
+    glm::mat4 m_projectionMatrix;
+    uint64_t m_uploadedTilesVersion = 0;
+
+    TextureHandle m_backgroundTexture;
+    std::unique_ptr<FBO> m_backgroundFBO;
+    std::unique_ptr<Sprite> m_backgroundSprite;
 
     bool zPressed = false;
     bool ctrlPressed = false;
     bool shouldNewCellBeGenerated = false;
     bool shouldFieldStateBeSaved = false;
     bool gameOver = false;
+    bool m_resourcesLoaded = false;
+    bool m_dirty = true; // the board changed since the last published snapshot
     int NumberOfUsedCells;
+    float m_animationTime = 0.f; // seconds since the move started
+    std::vector<AnimatedTileRenderer::Tile> m_tiles; // last published
+    std::vector<AnimatedTileRenderer::Tile> m_mergedAwayTiles; // tiles the current move removed
+    uint64_t m_tilesVersion = 0;
+    GameStatsTracker m_statsTracker;
+    GameStats m_previousStats; // for CTRL + Z, saved with previousFieldState
+    EAutoplay m_autoplay = EAutoplay::OFF; // A cycles, the AI moves whenever the tiles have settled
+    std::unique_ptr<Heuristic> m_heuristic; // created on the first A press
+    std::unique_ptr<TranspositionTable> m_searchTable;
+    std::unique_ptr<ExpectimaxSearch> m_search;
+    std::unique_ptr<MonteCarloPolicy> m_monteCarlo; // created when A first reaches it
+    NTupleWeightFile m_nTuples; // mapped at start when --ntuple is given
+    SolutionTable m_solution; // mapped at start when --solution names a table of this board size
+    std::unique_ptr<HintEngine> m_hintEngine; // H toggles hints, read by the render thread
+    bool m_hints = false;
+    uint32_t m_hintPosition = 0; // being analysed for the current board, 0 while the board moves
+    uint32_t m_lastHintPosition = 0;
+
+    TripleBuffer<Snapshot> m_snapshots;
+    std::deque<InputEvent> m_inputEvents;
+    std::mutex m_inputMutex;
+    std::condition_variable m_inputCondition;
+    bool m_renderWork = false; // guarded by m_renderMutex
+    std::mutex m_renderMutex;
+    std::condition_variable m_renderCondition;
+    std::atomic<uint64_t> m_framebufferSize; // width << 32 | height, written by the main thread
+    std::atomic<bool> m_resizePending;
+    std::atomic<bool> m_refreshPending;
+    std::atomic<bool> m_stopping;
+    std::thread m_logicThread;
+    std::thread m_renderThread;
+
+    void logicLoop();
+    void renderLoop();
+    void stopThreads();
+    void processInput();
+    void waitForInput();
+    void advanceAnimation();
+    void publishSnapshot();
+    void collectTiles(std::vector<AnimatedTileRenderer::Tile>& tiles) const;
+    Bitboard::Board getBitboard() const;
+    void cycleAutoplay();
+    void playAutoMove();
+    void requestHint(); // after every spawn and undo
+    void dropHint();
+    void wakeRenderer();
+    void waitForRenderWork();
+    void applyPendingResize();
 
-    void update();
     void loadResources();
+    void showLoadingScreen();
+    void createSprites();
+    void createBackground();
+    void updateLayout();
     void fieldInit();
 
-    void showGame();
-    void animationLeft(int j, int i, float& k);
-    void animationRight(int j, int i, float& k);
-    void animationDown(int j, int i, float& k);
-    void animationUp(int j, int i, float& k);
+    void showGame(const Snapshot& state);
+    void updateText(const Snapshot& state); // HUD, labels for the tiles past the atlas and the hint arrow
     int getNumberOfUsedCells();
 
     bool isCellInField(int x, int y);
@@ -78,16 +171,43 @@ class Game2048 {
     void restartGame();
 
     static void keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void windowRefreshCallback(GLFWwindow* window);
+    static void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+    void handleResize(int width, int height);
     void handleKey(int key, int action);
 
+    void beginMove();
     void moveCell(int x, int y, int dx, int dy);
-    std::pair<int, int> getNewCellPosition(int x, int y, int key, int count);
+    std::pair<int, int> getNewCellPosition(int x, int y, int key, uint32_t count);
     void mergeCells(int x, int y, int dx, int dy);
 
-    enum class EAnimations { RIGHT, LEFT, DOWN, UP, NONE };
     EAnimations m_currentAnimation;
 
 public:
-    Game2048(GLFWwindow* _window, size_t width, size_t height);
-    void run();
+    struct FrameStats {
+        uint64_t renderedFrames = 0;
+        uint64_t skippedFrames = 0;
+    };
+
+    struct AutoplayStats {
+        uint64_t moves = 0;
+        uint64_t depth = 0; // summed over moves
+        uint64_t nodes = 0;
+        double milliseconds = 0.0;
+        uint64_t monteCarloMoves = 0;
+        uint64_t rollouts = 0;
+        double monteCarloMilliseconds = 0.0;
+        uint64_t nTupleMoves = 0;
+        uint64_t exactMoves = 0;
+    };
+
+    Game2048(GLFWwindow* _window, size_t width, size_t height, FramePacer& framePacer, const std::string& nTupleWeights = std::string(), const std::string& solutionTable = std::string());
+    void run(); // returns once the window is closed, with the context current again
+    const FrameStats& getFrameStats() const;
+    const GameStats& getGameStats() const; // once run() has returned
+    const AutoplayStats& getAutoplayStats() const; // once run() has returned
+
+private:
+    FrameStats m_frameStats; // render thread
+    AutoplayStats m_autoplayStats; // logic thread
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "GameStats.hpp"
+
+#include <algorithm>
+
+double GameStats::getAverageMergesPerMove() const {
+    return moves ? static_cast<double>(merges) / moves : 0.0;
+}
+
+double GameStats::getAverageMoveTime() const {
+    return moves ? totalMoveTime / moves : 0.0;
+}
+
+GameStatsTracker::GameStatsTracker() {
+    reset();
+}
+
+void GameStatsTracker::reset() {
+    m_stats = GameStats();
+    m_pendingMerges = 0;
+    m_lastMove = Clock::now();
+}
+
+void GameStatsTracker::onSpawn(uint32_t value) {
+    m_stats.maxTile = std::max(m_stats.maxTile, value);
+}
+
+void GameStatsTracker::onMerge(uint32_t value) {
+    m_stats.score += value;
+    m_stats.maxTile = std::max(m_stats.maxTile, value);
+    m_stats.merges++;
+    m_pendingMerges++;
+}
+
+void GameStatsTracker::onMerges(uint32_t count, uint64_t score, uint32_t maxTile) {
+    m_stats.score += score;
+    m_stats.maxTile = std::max(m_stats.maxTile, maxTile);
+    m_stats.merges += count;
+    m_pendingMerges += count;
+}
+
+void GameStatsTracker::onMove() {
+    Clock::time_point now = Clock::now();
+    m_stats.lastMoveTime = std::chrono::duration<double>(now - m_lastMove).count();
+    m_stats.totalMoveTime += m_stats.lastMoveTime;
+    m_lastMove = now;
+
+    m_stats.moves++;
+    m_stats.lastMoveMerges = m_pendingMerges;
+    m_stats.maxMergesPerMove = std::max(m_stats.maxMergesPerMove, m_pendingMerges);
+    m_pendingMerges = 0;
+}
+
+void GameStatsTracker::restore(const GameStats& stats) {
+    m_stats = stats;
+    m_pendingMerges = 0;
+}
+
+const GameStats& GameStatsTracker::getStats() const {
+    return m_stats;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Running statistics of one game. Plain fixed-size data, so snapshots and undo copy
+// it by value.
+struct GameStats {
+    uint64_t score = 0; // sum of every merged tile, as in the original game
+    uint32_t maxTile = 0;
+    uint32_t moves = 0;
+    uint32_t merges = 0;
+    uint32_t lastMoveMerges = 0;
+    uint32_t maxMergesPerMove = 0;
+    double lastMoveTime = 0.0; // seconds since the previous move
+    double totalMoveTime = 0.0;
+
+    double getAverageMergesPerMove() const;
+    double getAverageMoveTime() const;
+};
+
+// Updates GameStats from game events alone, the board is never rescanned.
+// Merges are counted as they happen and credited to the move that follows.
+class GameStatsTracker {
+public:
+    GameStatsTracker();
+
+    void reset();
+    void onSpawn(uint32_t value);
+    void onMerge(uint32_t value); // value of the tile the merge produced
+    void onMerges(uint32_t count, uint64_t score, uint32_t maxTile); // a whole move's merges, as Bitboard::move reports them
+    void onMove(); // once per move that changed the board, after its merges
+    void restore(const GameStats& stats); // undo, the move clock keeps running
+
+    const GameStats& getStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    GameStats m_stats;
+    uint32_t m_pendingMerges = 0;
+    Clock::time_point m_lastMove;
+};
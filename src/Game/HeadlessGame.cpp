@@ -0,0 +1,60 @@
+#include "HeadlessGame.hpp"
+
+HeadlessGame::HeadlessGame(uint32_t seed) : m_random(seed) {
+    spawn();
+    spawn();
+}
+
+bool HeadlessGame::play(Bitboard::EDirection direction) {
+    Bitboard::Merges merges;
+    Bitboard::Board moved = Bitboard::move(m_board, direction, merges);
+    if (moved == m_board) return false;
+
+    m_board = moved;
+    m_statsTracker.onMerges(merges.count, merges.score, merges.maxExponent ? 1u << merges.maxExponent : 0);
+    m_statsTracker.onMove();
+    spawn();
+    return true;
+}
+
+bool HeadlessGame::isOver() const {
+    return !Bitboard::canMove(m_board);
+}
+
+Bitboard::Board HeadlessGame::getBoard() const {
+    return m_board;
+}
+
+uint64_t HeadlessGame::getScore() const {
+    return m_statsTracker.getStats().score;
+}
+
+int HeadlessGame::getMoves() const {
+    return static_cast<int>(m_statsTracker.getStats().moves);
+}
+
+int HeadlessGame::getMaxExponent() const {
+    int exponent = 0;
+    while ((m_statsTracker.getStats().maxTile >> (exponent + 1)) != 0) exponent++;
+    return exponent;
+}
+
+const GameStats& HeadlessGame::getStats() const {
+    return m_statsTracker.getStats();
+}
+
+uint64_t HeadlessGame::scoreOf(Bitboard::Board board, int fourSpawns) {
+    uint64_t score = 0;
+    for (int i = 0; i < 16; i++, board >>= 4) {
+        int exponent = static_cast<int>(board & 0xF);
+        if (exponent >= 2) score += static_cast<uint64_t>(exponent - 1) << exponent;
+    }
+    uint64_t skipped = static_cast<uint64_t>(fourSpawns) * 4;
+    return score > skipped ? score - skipped : 0;
+}
+
+void HeadlessGame::spawn() {
+    Bitboard::Board spawned = Bitboard::spawnTile(m_board, static_cast<uint32_t>(m_random()));
+    m_statsTracker.onSpawn(((spawned ^ m_board) >> 1) & 0x1111111111111111ULL ? 4 : 2); // a 4 is exponent 2, a 2 is exponent 1
+    m_board = spawned;
+}
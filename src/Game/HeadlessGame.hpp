@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Bitboard.hpp"
+#include "GameStats.hpp"
+
+#include <cstdint>
+#include <random>
+
+// One game of 2048 on a Bitboard without any window, for simulations and training.
+// The seed fixes every spawn, so the same seed and the same moves replay the same game.
+// Score and tiles come from the merges and spawns as they happen, like in Game2048.
+class HeadlessGame {
+public:
+    explicit HeadlessGame(uint32_t seed);
+
+    bool play(Bitboard::EDirection direction); // moves and spawns, false when the move changes nothing
+    bool isOver() const;
+
+    Bitboard::Board getBoard() const;
+    uint64_t getScore() const; // sum of all merged tile values, like GameStats::score
+    int getMoves() const;
+    int getMaxExponent() const;
+    const GameStats& getStats() const;
+
+    static uint64_t scoreOf(Bitboard::Board board, int fourSpawns); // a 2^k tile took k - 1 merges of 2^k, a spawned 4 skipped one
+
+private:
+    std::mt19937 m_random;
+    Bitboard::Board m_board = 0;
+    GameStatsTracker m_statsTracker;
+
+    void spawn();
+};
@@ -0,0 +1,151 @@
+#include "LargeBoard.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <thread>
+
+LargeBoard::LargeBoard(int size)
+    : m_size(size), m_cells(static_cast<size_t>(size) * size), m_random(static_cast<unsigned int>(std::time(NULL)))
+{
+    reset();
+}
+
+void LargeBoard::reset() {
+    std::fill(m_cells.begin(), m_cells.end(), 0);
+    m_dirtyChunks.assign(static_cast<size_t>(getChunksPerSide()) * getChunksPerSide(), 1);
+    m_emptyCells = m_cells.size();
+
+    for (size_t i = 0; i < m_cells.size() / 2; i++) spawnCell(); // half full, so moves have work to do
+}
+
+bool LargeBoard::move(EDirection direction) {
+    std::vector<LineResult> results(m_size);
+
+    int threads = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()), m_size / 16));
+    std::vector<std::thread> workers;
+    int linesPerThread = (m_size + threads - 1) / threads;
+    for (int t = 1; t < threads; t++) {
+        int first = t * linesPerThread;
+        int last = std::min(m_size, first + linesPerThread);
+        if (first < last) workers.emplace_back(&LargeBoard::processLines, this, direction, first, last, std::ref(results));
+    }
+    processLines(direction, 0, std::min(m_size, linesPerThread), results);
+    for (std::thread& worker : workers) worker.join();
+
+    bool moved = false;
+    for (int line = 0; line < m_size; line++) {
+        const LineResult& result = results[line];
+        m_emptyCells += result.merges;
+        if (result.firstChanged < 0) continue;
+        moved = true;
+
+        bool reversed = direction == EDirection::RIGHT || direction == EDirection::UP;
+        int first = reversed ? m_size - 1 - result.lastChanged : result.firstChanged;
+        int last = reversed ? m_size - 1 - result.firstChanged : result.lastChanged;
+        for (int chunk = first / CHUNK_SIZE; chunk <= last / CHUNK_SIZE; chunk++) {
+            if (direction == EDirection::LEFT || direction == EDirection::RIGHT) markChunkDirty(chunk * CHUNK_SIZE, line);
+            else markChunkDirty(line, chunk * CHUNK_SIZE);
+        }
+    }
+
+    if (moved) {
+        int spawns = std::max(1, m_size / 4); // one tile per move would leave a big board empty forever
+        for (int i = 0; i < spawns && m_emptyCells > 0; i++) spawnCell();
+    }
+    return moved;
+}
+
+bool LargeBoard::canMove() const {
+    if (m_emptyCells > 0) return true;
+    for (int y = 0; y < m_size; y++)
+        for (int x = 0; x < m_size; x++) {
+            uint8_t value = getCell(x, y);
+            if (value == UINT8_MAX) continue;
+            if (x + 1 < m_size && getCell(x + 1, y) == value) return true;
+            if (y + 1 < m_size && getCell(x, y + 1) == value) return true;
+        }
+    return false;
+}
+
+int LargeBoard::getSize() const {
+    return m_size;
+}
+
+int LargeBoard::getChunksPerSide() const {
+    return (m_size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+uint8_t LargeBoard::getCell(int x, int y) const {
+    return m_cells[static_cast<size_t>(y) * m_size + x];
+}
+
+const uint8_t* LargeBoard::getCells() const {
+    return m_cells.data();
+}
+
+bool LargeBoard::isChunkDirty(int chunkX, int chunkY) const {
+    return m_dirtyChunks[static_cast<size_t>(chunkY) * getChunksPerSide() + chunkX] != 0;
+}
+
+void LargeBoard::clearDirtyChunks() {
+    std::fill(m_dirtyChunks.begin(), m_dirtyChunks.end(), 0);
+}
+
+void LargeBoard::processLines(EDirection direction, int firstLine, int lastLine, std::vector<LineResult>& results) {
+    std::vector<uint8_t> line(m_size);
+
+    for (int l = firstLine; l < lastLine; l++) {
+        // walk the line in the direction tiles slide to
+        std::ptrdiff_t start, step;
+        switch (direction) {
+        case EDirection::LEFT:  start = static_cast<std::ptrdiff_t>(l) * m_size;              step = 1;       break;
+        case EDirection::RIGHT: start = static_cast<std::ptrdiff_t>(l) * m_size + m_size - 1; step = -1;      break;
+        case EDirection::DOWN:  start = l;                                                step = m_size;  break;
+        default:                start = static_cast<std::ptrdiff_t>(m_size - 1) * m_size + l; step = -m_size; break;
+        }
+
+        LineResult& result = results[l];
+        result.firstChanged = result.lastChanged = -1;
+        result.merges = 0;
+
+        int count = 0;
+        bool canMerge = false;
+        for (int i = 0; i < m_size; i++) {
+            uint8_t value = m_cells[start + i * step];
+            if (!value) continue;
+            if (canMerge && line[count - 1] == value && value < UINT8_MAX) {
+                line[count - 1]++;
+                result.merges++;
+                canMerge = false;
+            }
+            else {
+                line[count++] = value;
+                canMerge = true;
+            }
+        }
+        std::fill(line.begin() + count, line.end(), 0);
+
+        for (int i = 0; i < m_size; i++) {
+            uint8_t& cell = m_cells[start + i * step];
+            if (cell == line[i]) continue;
+            cell = line[i];
+            if (result.firstChanged < 0) result.firstChanged = i;
+            result.lastChanged = i;
+        }
+    }
+}
+
+void LargeBoard::spawnCell() {
+    std::uniform_int_distribution<size_t> cellDistribution(0, m_cells.size() - 1);
+    size_t index = cellDistribution(m_random);
+    while (m_cells[index]) index = (index + 1) % m_cells.size(); // fine while the board has room
+
+    m_cells[index] = (m_random() % 10 < 9) ? 1 : 2;
+    m_emptyCells--;
+    markChunkDirty(static_cast<int>(index % m_size), static_cast<int>(index / m_size));
+}
+
+void LargeBoard::markChunkDirty(int x, int y) {
+    m_dirtyChunks[static_cast<size_t>(y / CHUNK_SIZE) * getChunksPerSide() + x / CHUNK_SIZE] = 1;
+}
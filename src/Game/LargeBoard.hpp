@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Square board stored as one flat array of tile exponents (0 is empty, k is 2^k),
+// row by row from the bottom. Moves run lines in parallel and report which
+// chunks of CHUNK_SIZE x CHUNK_SIZE cells changed so the renderer re-uploads only those.
+class LargeBoard {
+public:
+    enum class EDirection { LEFT, RIGHT, DOWN, UP };
+
+    static const int CHUNK_SIZE = 32;
+
+    explicit LargeBoard(int size);
+
+    void reset();
+    bool move(EDirection direction); // false when nothing moved
+    bool canMove() const;
+
+    int getSize() const;
+    int getChunksPerSide() const;
+    uint8_t getCell(int x, int y) const;
+    const uint8_t* getCells() const;
+
+    bool isChunkDirty(int chunkX, int chunkY) const;
+    void clearDirtyChunks();
+
+private:
+    const int m_size;
+    std::vector<uint8_t> m_cells;
+    std::vector<uint8_t> m_dirtyChunks;
+    size_t m_emptyCells;
+    std::mt19937 m_random;
+
+    struct LineResult {
+        int firstChanged;
+        int lastChanged;
+        int merges;
+    };
+
+    void processLines(EDirection direction, int firstLine, int lastLine, std::vector<LineResult>& results);
+    void spawnCell();
+    void markChunkDirty(int x, int y);
+};
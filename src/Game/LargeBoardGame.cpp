@@ -0,0 +1,208 @@
+#include "LargeBoardGame.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static const glm::vec4 BOARD_COLOR(0.73f, 0.68f, 0.63f, 1.f);
+static const glm::vec4 TILE_LABEL_COLOR(0.98f, 0.96f, 0.94f, 1.f);
+static const uint8_t LAST_ATLAS_EXPONENT = 15; // cells.png ends at 32768
+static const float MIN_LABEL_PIXELS_PER_CELL = 24.f; // below that the digits are unreadable anyway
+
+LargeBoardGame::LargeBoardGame(GLFWwindow* _window, size_t width, size_t height, int boardSize, FramePacer& framePacer)
+    : window(_window), m_windowWidth(width), m_windowHeight(height), m_framePacer(framePacer), m_board(boardSize)
+{
+    glfwSetWindowUserPointer(window, this);
+    glfwSetKeyCallback(window, keysCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetCursorPosCallback(window, cursorPosCallback);
+    glfwSetScrollCallback(window, scrollCallback);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+
+    m_cellTexture = ResourceManager::loadTexture("res/textures/cells.png");
+    m_boardShaderProg = ResourceManager::loadShaderProgram("res/shaders/vBoard.txt", "res/shaders/fBoard.txt");
+    m_textShaderProg = ResourceManager::loadShaderProgram("res/shaders/vText.txt", "res/shaders/fText.txt");
+    fitBoard();
+}
+
+void LargeBoardGame::run() {
+    while (!glfwWindowShouldClose(window)) {
+        if (!m_resourcesLoaded) {
+            showLoadingScreen();
+            continue;
+        }
+
+        if (m_dirty) glfwPollEvents();
+        else {
+            m_framePacer.pause();
+            glfwWaitEvents();
+        }
+        if (!m_dirty) continue;
+
+        showGame();
+        Renderer::captureFrame(m_windowWidth, m_windowHeight);
+        glfwSwapBuffers(window);
+        m_framePacer.frameFinished();
+        m_dirty = false;
+    }
+}
+
+void LargeBoardGame::showLoadingScreen() {
+    if (ResourceManager::update()) {
+        m_renderer.reset(new ChunkedBoardRenderer(m_board.getSize(), LargeBoard::CHUNK_SIZE, m_cellTexture, m_boardShaderProg));
+        m_labels.reset(new TextRenderer(m_textShaderProg));
+        m_resourcesLoaded = true;
+    }
+
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+    glfwSwapBuffers(window);
+    m_framePacer.frameFinished();
+    glfwPollEvents();
+}
+
+void LargeBoardGame::showGame() {
+    uploadDirtyChunks();
+
+    Renderer::viewport(0, 0, m_windowWidth, m_windowHeight);
+    Renderer::clearColor(BOARD_COLOR.r, BOARD_COLOR.g, BOARD_COLOR.b, BOARD_COLOR.a);
+    Renderer::clear();
+
+    glm::vec4 area = getVisibleArea();
+    glm::mat4 projection = glm::ortho(area.x, area.z, area.y, area.w, -1.f, 1.f);
+    m_renderer->render(projection, area);
+
+    updateLabels(area);
+    m_labels->render(projection);
+}
+
+void LargeBoardGame::updateLabels(const glm::vec4& area) { // only runs for frames that changed, so rebuilding is fine
+    m_labels->clear();
+    if (m_pixelsPerCell < MIN_LABEL_PIXELS_PER_CELL) return;
+
+    int size = m_board.getSize();
+    int minX = std::max(static_cast<int>(std::floor(area.x)), 0);
+    int minY = std::max(static_cast<int>(std::floor(area.y)), 0);
+    int maxX = std::min(static_cast<int>(std::ceil(area.z)), size);
+    int maxY = std::min(static_cast<int>(std::ceil(area.w)), size);
+
+    for (int y = minY; y < maxY; y++)
+        for (int x = minX; x < maxX; x++) {
+            uint8_t exponent = m_board.getCell(x, y);
+            if (exponent <= LAST_ATLAS_EXPONENT) continue;
+
+            std::string label = std::to_string(uint64_t(1) << std::min<int>(exponent, 63));
+            float height = std::min(0.3f, 0.85f / m_labels->measure(label, 1.f)); // in cells, long numbers shrink to fit
+            glm::vec2 position = glm::vec2(x + 0.5f, y + 0.5f) - glm::vec2(m_labels->measure(label, height), height) * 0.5f;
+            m_labels->addText(label, position, height, TILE_LABEL_COLOR);
+        }
+}
+
+void LargeBoardGame::uploadDirtyChunks() {
+    int chunks = m_board.getChunksPerSide();
+    for (int y = 0; y < chunks; y++)
+        for (int x = 0; x < chunks; x++)
+            if (m_board.isChunkDirty(x, y)) m_renderer->uploadChunk(x, y, m_board.getCells());
+    m_board.clearDirtyChunks();
+}
+
+void LargeBoardGame::fitBoard() {
+    m_viewCenter = glm::vec2(m_board.getSize() * 0.5f);
+    m_pixelsPerCell = static_cast<float>(std::min(m_windowWidth, m_windowHeight)) / m_board.getSize();
+    m_dirty = true;
+}
+
+glm::vec4 LargeBoardGame::getVisibleArea() const {
+    glm::vec2 halfExtent = glm::vec2(m_windowWidth, m_windowHeight) * (0.5f / m_pixelsPerCell);
+    return glm::vec4(m_viewCenter - halfExtent, m_viewCenter + halfExtent);
+}
+
+float LargeBoardGame::getCursorScale() const {
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    return width > 0 ? static_cast<float>(m_windowWidth) / width : 1.f;
+}
+
+void LargeBoardGame::keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+    game->handleKey(key, action);
+}
+
+void LargeBoardGame::handleKey(int key, int action) {
+    if (action != GLFW_PRESS) return;
+
+    LargeBoard::EDirection direction;
+    switch (key) {
+    case GLFW_KEY_LEFT:  direction = LargeBoard::EDirection::LEFT;  break;
+    case GLFW_KEY_RIGHT: direction = LargeBoard::EDirection::RIGHT; break;
+    case GLFW_KEY_DOWN:  direction = LargeBoard::EDirection::DOWN;  break;
+    case GLFW_KEY_UP:    direction = LargeBoard::EDirection::UP;    break;
+    case GLFW_KEY_HOME:
+        fitBoard();
+        return;
+    case GLFW_KEY_ESCAPE:
+        glfwSetWindowShouldClose(window, true);
+        return;
+    default:
+        return;
+    }
+
+    if (gameOver) {
+        m_board.reset();
+        gameOver = false;
+    }
+    else if (!m_board.move(direction) && !m_board.canMove()) {
+        gameOver = true;
+    }
+    m_dirty = true;
+}
+
+void LargeBoardGame::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+
+    game->m_dragging = action == GLFW_PRESS;
+    glfwGetCursorPos(window, &game->m_lastCursorX, &game->m_lastCursorY);
+}
+
+void LargeBoardGame::cursorPosCallback(GLFWwindow* window, double x, double y) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+    if (game->m_dragging) {
+        float scale = game->getCursorScale() / game->m_pixelsPerCell;
+        game->m_viewCenter.x -= static_cast<float>(x - game->m_lastCursorX) * scale;
+        game->m_viewCenter.y += static_cast<float>(y - game->m_lastCursorY) * scale; // screen y grows down
+        game->m_dirty = true;
+    }
+    game->m_lastCursorX = x;
+    game->m_lastCursorY = y;
+}
+
+void LargeBoardGame::scrollCallback(GLFWwindow* window, double xoffset, double yoffset) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+
+    // keep the cell under the cursor in place
+    double cursorX, cursorY;
+    glfwGetCursorPos(window, &cursorX, &cursorY);
+    float scale = game->getCursorScale();
+    glm::vec2 cursorOffset(cursorX * scale - game->m_windowWidth * 0.5, game->m_windowHeight * 0.5 - cursorY * scale);
+    glm::vec2 cursorCell = game->m_viewCenter + cursorOffset / game->m_pixelsPerCell;
+
+    float minPixelsPerCell = 0.25f * std::min(game->m_windowWidth, game->m_windowHeight) / game->m_board.getSize();
+    game->m_pixelsPerCell = glm::clamp(game->m_pixelsPerCell * std::pow(1.1f, static_cast<float>(yoffset)), minPixelsPerCell, 512.f);
+    game->m_viewCenter = cursorCell - cursorOffset / game->m_pixelsPerCell;
+    game->m_dirty = true;
+}
+
+void LargeBoardGame::framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+    if (width <= 0 || height <= 0) return;
+
+    game->m_windowWidth = width;
+    game->m_windowHeight = height;
+    game->m_dirty = true;
+}
+
+void LargeBoardGame::windowRefreshCallback(GLFWwindow* window) {
+    LargeBoardGame* game = static_cast<LargeBoardGame*>(glfwGetWindowUserPointer(window));
+    game->m_dirty = true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <memory>
+#include "LargeBoard.hpp"
+#include "../Graphics/ChunkedBoardRenderer.hpp"
+#include "../Graphics/TextRenderer.hpp"
+#include "../Graphics/FramePacer.hpp"
+
+// Stress mode for boards far larger than 4x4: arrows move, mouse drag pans,
+// the wheel zooms around the cursor and Home fits the whole board. Tiles past 32768
+// get their value written on them once the zoom leaves room for the text.
+class LargeBoardGame {
+    GLFWwindow* window;
+    size_t m_windowWidth; // framebuffer size in pixels
+    size_t m_windowHeight;
+
+    FramePacer& m_framePacer;
+    LargeBoard m_board;
+    std::unique_ptr<ChunkedBoardRenderer> m_renderer;
+    TextureHandle m_cellTexture;
+    ShaderProgramHandle m_boardShaderProg;
+    std::unique_ptr<TextRenderer> m_labels;
+    ShaderProgramHandle m_textShaderProg;
+
+    glm::vec2 m_viewCenter; // in cells
+    float m_pixelsPerCell;
+    bool m_dragging = false;
+    double m_lastCursorX = 0.0;
+    double m_lastCursorY = 0.0;
+
+    bool m_resourcesLoaded = false;
+    bool m_dirty = true;
+    bool gameOver = false;
+
+    void showLoadingScreen();
+    void showGame();
+    void uploadDirtyChunks();
+    void updateLabels(const glm::vec4& area);
+    void fitBoard();
+    glm::vec4 getVisibleArea() const;
+    float getCursorScale() const; // framebuffer pixels per screen coordinate
+
+    static void keysCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void cursorPosCallback(GLFWwindow* window, double x, double y);
+    static void scrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+    static void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+    static void windowRefreshCallback(GLFWwindow* window);
+    void handleKey(int key, int action);
+
+public:
+    LargeBoardGame(GLFWwindow* _window, size_t width, size_t height, int boardSize, FramePacer& framePacer);
+    void run();
+};
@@ -0,0 +1,80 @@
+#include "SelfPlayFarm.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+SelfPlayFarm::SelfPlayFarm(size_t boardCount, unsigned int threadCount, unsigned int movesPerSecond)
+    : m_boardCount(boardCount), m_movesPerSecond(movesPerSecond), m_boards(new std::atomic<Bitboard::Board>[boardCount]),
+    m_movesPlayed(0), m_gamesFinished(0), m_stop(false)
+{
+    for (size_t i = 0; i < boardCount; i++) m_boards[i].store(0, std::memory_order_relaxed);
+
+    threadCount = std::max(1u, std::min(threadCount, static_cast<unsigned int>(boardCount)));
+    size_t boardsPerThread = (boardCount + threadCount - 1) / threadCount;
+    std::random_device seeds;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        size_t first = t * boardsPerThread;
+        size_t last = std::min(boardCount, first + boardsPerThread);
+        if (first < last) m_workers.emplace_back(&SelfPlayFarm::workerLoop, this, first, last, seeds());
+    }
+}
+
+SelfPlayFarm::~SelfPlayFarm() {
+    m_stop.store(true);
+    for (std::thread& worker : m_workers) worker.join();
+}
+
+size_t SelfPlayFarm::getBoardCount() const {
+    return m_boardCount;
+}
+
+void SelfPlayFarm::readBoards(Bitboard::Board* boards) const {
+    for (size_t i = 0; i < m_boardCount; i++) boards[i] = m_boards[i].load(std::memory_order_relaxed);
+}
+
+uint64_t SelfPlayFarm::getMovesPlayed() const {
+    return m_movesPlayed.load(std::memory_order_relaxed);
+}
+
+uint64_t SelfPlayFarm::getGamesFinished() const {
+    return m_gamesFinished.load(std::memory_order_relaxed);
+}
+
+void SelfPlayFarm::workerLoop(size_t firstBoard, size_t lastBoard, unsigned int seed) {
+    std::mt19937 random(seed);
+    std::vector<Bitboard::Board> boards(lastBoard - firstBoard, 0);
+    const Bitboard::EDirection directions[4] = { Bitboard::EDirection::LEFT, Bitboard::EDirection::RIGHT, Bitboard::EDirection::DOWN, Bitboard::EDirection::UP };
+
+    auto nextStep = std::chrono::steady_clock::now();
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        uint64_t finished = 0;
+        for (size_t i = 0; i < boards.size(); i++) {
+            Bitboard::Board& board = boards[i];
+            if (board == 0) {
+                board = Bitboard::spawnTile(Bitboard::spawnTile(0, random()), random());
+            }
+            else {
+                // random legal move, the farm only needs games that look alive
+                Bitboard::Board moved = board;
+                for (int start = random() % 4, k = 0; k < 4 && moved == board; k++) {
+                    moved = Bitboard::move(board, directions[(start + k) % 4]);
+                }
+                if (moved == board) {
+                    board = 0;
+                    finished++;
+                    continue;
+                }
+                board = Bitboard::spawnTile(moved, random());
+            }
+            m_boards[firstBoard + i].store(board, std::memory_order_relaxed);
+        }
+        m_movesPlayed.fetch_add(boards.size(), std::memory_order_relaxed);
+        m_gamesFinished.fetch_add(finished, std::memory_order_relaxed);
+
+        if (m_movesPerSecond > 0) {
+            nextStep += std::chrono::microseconds(1000000 / m_movesPerSecond);
+            std::this_thread::sleep_until(nextStep);
+        }
+    }
+}
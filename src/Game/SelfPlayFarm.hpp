@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Bitboard.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Plays many independent games on worker threads. Every board lives in one shared
+// array of atomics that the workers overwrite after each move, so readers take
+// snapshots without locks and never hold the workers up.
+class SelfPlayFarm {
+public:
+    SelfPlayFarm(size_t boardCount, unsigned int threadCount, unsigned int movesPerSecond); // 0 moves per second is unthrottled
+    ~SelfPlayFarm();
+
+    SelfPlayFarm(const SelfPlayFarm&) = delete;
+    SelfPlayFarm& operator=(const SelfPlayFarm&) = delete;
+
+    size_t getBoardCount() const;
+    void readBoards(Bitboard::Board* boards) const;
+    uint64_t getMovesPlayed() const;
+    uint64_t getGamesFinished() const;
+
+private:
+    const size_t m_boardCount;
+    const unsigned int m_movesPerSecond;
+    std::unique_ptr<std::atomic<Bitboard::Board>[]> m_boards;
+    std::atomic<uint64_t> m_movesPlayed;
+    std::atomic<uint64_t> m_gamesFinished;
+    std::atomic<bool> m_stop;
+    std::vector<std::thread> m_workers;
+
+    void workerLoop(size_t firstBoard, size_t lastBoard, unsigned int seed);
+};
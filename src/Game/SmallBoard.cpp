@@ -0,0 +1,96 @@
+#include "SmallBoard.hpp"
+#include "BoardSymmetry.hpp"
+
+#include <algorithm>
+
+SmallBoard::SmallBoard(int width, int height) : m_width(std::max(2, std::min(width, 4))), m_height(std::max(2, std::min(height, 4))),
+    m_rowMask((static_cast<uint64_t>(1) << (4 * m_width)) - 1) {
+}
+
+SmallBoard::State SmallBoard::move(State state, Bitboard::EDirection direction) const {
+    // the cells past the board are empty and stay so, the tiles slide away from them
+    int shift = (direction == Bitboard::EDirection::RIGHT ? 4 * (4 - m_width) : 0) + (direction == Bitboard::EDirection::UP ? 16 * (4 - m_height) : 0);
+    return extract(Bitboard::move(embed(state) << shift, direction) >> shift);
+}
+
+bool SmallBoard::canMove(State state) const {
+    for (int direction = 0; direction < 4; direction++) {
+        if (move(state, static_cast<Bitboard::EDirection>(direction)) != state) return true;
+    }
+    return false;
+}
+
+SmallBoard::State SmallBoard::canonicalize(State state) const {
+    // a mirrored image lies in the opposite corner and shifts back, transposing keeps a square board in place;
+    // embedding keeps the order of the cells, so the smallest image is the same in either layout
+    const int shiftX = 4 * (4 - m_width), shiftY = 16 * (4 - m_height);
+    Bitboard::Board board = embed(state);
+    Bitboard::Board flippedX = BoardSymmetry::flipX(board);
+    Bitboard::Board best = board; // the identity comes first
+    best = std::min(best, flippedX >> shiftX);
+    best = std::min(best, BoardSymmetry::flipY(board) >> shiftY);
+    best = std::min(best, BoardSymmetry::flipY(flippedX) >> (shiftX + shiftY));
+    if (m_width == m_height) {
+        Bitboard::Board transposed = Bitboard::transpose(board);
+        Bitboard::Board transposedX = BoardSymmetry::flipX(transposed);
+        best = std::min(best, transposed);
+        best = std::min(best, transposedX >> shiftX);
+        best = std::min(best, BoardSymmetry::flipY(transposed) >> shiftY);
+        best = std::min(best, BoardSymmetry::flipY(transposedX) >> (shiftX + shiftY));
+    }
+    return extract(best);
+}
+
+int SmallBoard::getWidth() const {
+    return m_width;
+}
+
+int SmallBoard::getHeight() const {
+    return m_height;
+}
+
+int SmallBoard::getCellCount() const {
+    return m_width * m_height;
+}
+
+int SmallBoard::getSymmetryCount() const {
+    return m_width == m_height ? BoardSymmetry::COUNT : BoardSymmetry::COUNT / 2;
+}
+
+int SmallBoard::getCell(State state, int cell) {
+    return static_cast<int>((state >> (4 * cell)) & 0xF);
+}
+
+SmallBoard::State SmallBoard::setCell(State state, int cell, int exponent) {
+    int shift = 4 * cell;
+    return (state & ~(static_cast<State>(0xF) << shift)) | (static_cast<State>(exponent & 0xF) << shift);
+}
+
+uint32_t SmallBoard::getTileSum(State state) {
+    uint32_t sum = 0;
+    for (; state; state >>= 4) {
+        int exponent = static_cast<int>(state & 0xF);
+        if (exponent) sum += 1u << exponent;
+    }
+    return sum;
+}
+
+int SmallBoard::getMaxExponent(State state) {
+    int maxExponent = 0;
+    for (; state; state >>= 4) maxExponent = std::max(maxExponent, static_cast<int>(state & 0xF));
+    return maxExponent;
+}
+
+Bitboard::Board SmallBoard::embed(State state) const {
+    if (m_width == 4) return state; // already the layout of Bitboard
+    Bitboard::Board board = 0;
+    for (int y = 0; y < m_height; y++) board |= ((state >> (4 * m_width * y)) & m_rowMask) << (16 * y);
+    return board;
+}
+
+SmallBoard::State SmallBoard::extract(Bitboard::Board board) const {
+    if (m_width == 4) return board;
+    State state = 0;
+    for (int y = 0; y < m_height; y++) state |= ((board >> (16 * y)) & m_rowMask) << (4 * m_width * y);
+    return state;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Bitboard.hpp"
+
+#include <cstdint>
+
+// The rules of Bitboard on a width x height board, 2 to 4 cells per side: cell (x, y)
+// is the nibble at 4 * (width * y + x), y = 0 is the bottom row. A move places the
+// board in the corner of a Bitboard it slides toward, so Bitboard's row tables slide it
+// and the empty cells around it stay empty. The symmetries are BoardSymmetry's on the
+// same embedding: the mirrorings, plus the transposed ones on square boards; values do
+// not change under them, so canonical states stand for all their images.
+class SmallBoard {
+public:
+    typedef uint64_t State;
+
+    SmallBoard(int width, int height);
+
+    State move(State state, Bitboard::EDirection direction) const;
+    bool canMove(State state) const;
+    State canonicalize(State state) const; // the smallest image
+
+    int getWidth() const;
+    int getHeight() const;
+    int getCellCount() const;
+    int getSymmetryCount() const;
+
+    static int getCell(State state, int cell);
+    static State setCell(State state, int cell, int exponent);
+    static uint32_t getTileSum(State state); // sum of the tile values, a move keeps it, a spawn adds 2 or 4
+    static int getMaxExponent(State state);
+
+private:
+    Bitboard::Board embed(State state) const; // cell (x, y) goes to cell (x, y) of a Bitboard
+    State extract(Bitboard::Board board) const; // undoes embed
+
+    int m_width;
+    int m_height;
+    uint64_t m_rowMask; // the width nibbles of one row
+};
@@ -0,0 +1,37 @@
+#include "AnimatedTileRenderer.hpp"
+
+#include <algorithm>
+
+AnimatedTileRenderer::AnimatedTileRenderer(int fieldWidth, size_t maxTiles, float speed, TextureHandle atlas, ShaderProgramHandle shaderProgram)
+	: m_fieldWidth(fieldWidth), m_maxTiles(maxTiles), m_speed(speed), m_atlas(atlas), m_shaderProgram(shaderProgram)
+{
+	m_quad.reset(new VBO(std::array<GLfloat, 8>{ 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f }));
+	m_instances.reset(new VBO(nullptr, maxTiles * sizeof(Tile)));
+
+	m_vao.reset(new VAO());
+	m_vao->addBuffer(m_quad->getID());
+	m_vao->addIntegerInstanceBuffer(m_instances->getID(), 4, GL_UNSIGNED_BYTE);
+
+	VBO::unbind();
+	VAO::unbind();
+}
+
+void AnimatedTileRenderer::upload(const Tile* tiles, size_t count) {
+	m_tileCount = std::min(count, m_maxTiles);
+	if (m_tileCount) m_instances->update(0, tiles, m_tileCount * sizeof(Tile));
+}
+
+void AnimatedTileRenderer::render(const glm::mat4& projection, float cellSize, float time) {
+	const Texture* texture = ResourceManager::getTexture(m_atlas);
+	ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(m_shaderProgram);
+	if (!texture || !shaderProgram || !m_tileCount) return;
+
+	shaderProgram->use();
+	shaderProgram->setInt("tex", 0);
+	shaderProgram->setMatrix4("projectionMat", projection);
+	shaderProgram->setInt("fieldWidth", m_fieldWidth);
+	shaderProgram->setFloat("cellSize", cellSize);
+	shaderProgram->setFloat("speed", m_speed);
+	shaderProgram->setFloat("time", time);
+	Renderer::renderInstanced(m_vao->getID(), *texture, *shaderProgram, static_cast<GLsizei>(m_tileCount));
+}
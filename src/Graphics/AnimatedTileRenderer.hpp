@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "VAO.hpp"
+#include "VBO.hpp"
+#include "../Resources/ResourceManager.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+
+// Draws the tiles of a small board in one instanced draw. Every tile carries the cell
+// it starts from and the cell it ends in, uploaded once per move; the vertex shader
+// slides it between the two from a single time uniform, so animation frames cost the
+// CPU nothing per tile.
+class AnimatedTileRenderer {
+public:
+	struct Tile {
+		uint8_t from; // cell index, y * fieldWidth + x
+		uint8_t to;
+		uint8_t exponent; // 1 is the 2 tile
+		uint8_t unused;
+	};
+
+	AnimatedTileRenderer(int fieldWidth, size_t maxTiles, float speed, TextureHandle atlas, ShaderProgramHandle shaderProgram); // speed in cells per second
+
+	AnimatedTileRenderer(const AnimatedTileRenderer&) = delete;
+	AnimatedTileRenderer& operator=(const AnimatedTileRenderer&) = delete;
+
+	void upload(const Tile* tiles, size_t count);
+	void render(const glm::mat4& projection, float cellSize, float time); // time in seconds since the move started
+
+private:
+	int m_fieldWidth;
+	size_t m_maxTiles;
+	float m_speed;
+	TextureHandle m_atlas;
+	ShaderProgramHandle m_shaderProgram;
+
+	std::unique_ptr<VBO> m_quad;
+	std::unique_ptr<VBO> m_instances;
+	std::unique_ptr<VAO> m_vao;
+	size_t m_tileCount = 0;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "TextureImage.hpp"
+
+#include <cstdint>
+
+// Built-in 5x7 font for ASCII 32-95, lower case letters map to upper case. The atlas
+// is a signed distance field generated at startup, so one texture serves any text size.
+// Glyph i sits in cell (i % ATLAS_COLUMNS, i / ATLAS_COLUMNS) counted from the
+// bottom-left, with the glyph's bottom-left font pixel at (1, 1) of the cell.
+class BitmapFont {
+public:
+	static const int GLYPH_WIDTH = 5;
+	static const int GLYPH_HEIGHT = 7;
+	static const int CELL_SIZE = 8; // glyph plus one pixel of padding around it
+	static const int ADVANCE = 6;
+	static const int ATLAS_COLUMNS = 16;
+	static const int GLYPH_COUNT = 64;
+	static const int DISTANCE_FIELD_SCALE = 8; // atlas texels per font pixel
+
+	static int glyphIndex(char c); // -1 when the font has no such glyph
+	static TextureImage buildDistanceFieldAtlas(); // RGBA, alpha 0.5 on the outline, one font pixel of spread each way
+
+private:
+	BitmapFont() = delete;
+
+	static const uint8_t GLYPHS[GLYPH_COUNT][GLYPH_HEIGHT]; // rows top to bottom, bit 4 is the leftmost pixel
+
+	static bool isSet(int glyph, int x, int y); // font pixel, y up from the glyph's bottom row
+	static float signedDistance(int glyph, float x, float y); // font pixels from the outline, positive inside
+};
@@ -0,0 +1,90 @@
+#include "BoardWallRenderer.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+BoardWallRenderer::BoardWallRenderer(size_t boardCount, TextureHandle atlas, ShaderProgramHandle shaderProgram)
+	: m_boardCount(boardCount), m_atlas(atlas), m_shaderProgram(shaderProgram), m_persistent(GLExtensions::hasBufferStorage())
+{
+	GLsizeiptr regionSize = static_cast<GLsizeiptr>(boardCount * sizeof(uint64_t));
+
+	m_VAO.reset(new VAO());
+	m_quad.reset(new VBO(std::array<GLfloat, 8>{ 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f }));
+	m_VAO->addBuffer(m_quad->getID());
+
+	if (m_persistent) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		m_instances.reset(new VBO(regionSize * RING_SIZE, flags));
+		m_mappedMemory = m_instances->map(0, regionSize * RING_SIZE, flags);
+		m_persistent = m_mappedMemory != nullptr;
+	}
+	if (!m_persistent) {
+		m_instances.reset(new VBO(nullptr, regionSize, GL_STREAM_DRAW));
+	}
+	m_VAO->addIntegerInstanceBuffer(m_instances->getID(), 2, GL_UNSIGNED_INT); // low and high half of each board
+
+	VBO::unbind();
+	VAO::unbind();
+}
+
+BoardWallRenderer::~BoardWallRenderer() {
+	for (GLsync fence : m_fences) {
+		if (fence) glDeleteSync(fence);
+	}
+	if (m_mappedMemory) {
+		VBO::bind(m_instances->getID());
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+}
+
+void BoardWallRenderer::render(const uint64_t* boards, unsigned int width, unsigned int height) {
+	const Texture* texture = ResourceManager::getTexture(m_atlas);
+	ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(m_shaderProgram);
+	if (!texture || !shaderProgram || m_boardCount == 0) return;
+
+	GLintptr offset = upload(boards);
+	VAO::bind(m_VAO->getID());
+	VBO::bind(m_instances->getID());
+	glVertexAttribIPointer(1, 2, GL_UNSIGNED_INT, 0, reinterpret_cast<const void*>(offset));
+
+	// as many columns as keep the thumbnails square and as large as possible
+	int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(m_boardCount * static_cast<double>(width) / std::max(1u, height)))));
+	int rows = static_cast<int>((m_boardCount + columns - 1) / columns);
+	float thumbnailSize = std::min(static_cast<float>(width) / columns, static_cast<float>(height) / rows);
+
+	shaderProgram->use();
+	shaderProgram->setInt("tex", 0);
+	shaderProgram->setInt("columns", columns);
+	shaderProgram->setFloat("thumbnailSize", thumbnailSize);
+	shaderProgram->setMatrix4("projectionMat", glm::ortho(0.f, static_cast<float>(width), static_cast<float>(height), 0.f, -1.f, 1.f));
+	Renderer::renderInstanced(m_VAO->getID(), *texture, *shaderProgram, static_cast<GLsizei>(m_boardCount));
+
+	if (m_persistent) {
+		m_fences[m_ringIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_ringIndex = (m_ringIndex + 1) % RING_SIZE;
+	}
+}
+
+GLintptr BoardWallRenderer::upload(const uint64_t* boards) {
+	GLsizeiptr regionSize = static_cast<GLsizeiptr>(m_boardCount * sizeof(uint64_t));
+
+	if (!m_persistent) {
+		m_instances->orphan(regionSize);
+		m_instances->update(0, boards, regionSize);
+		return 0;
+	}
+
+	GLsync& fence = m_fences[m_ringIndex];
+	if (fence) { // the GPU is two frames behind at most, this rarely waits
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	GLintptr offset = regionSize * m_ringIndex;
+	std::memcpy(static_cast<char*>(m_mappedMemory) + offset, boards, regionSize);
+	return offset;
+}
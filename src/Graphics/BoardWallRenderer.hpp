@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "VAO.hpp"
+#include "VBO.hpp"
+#include "../Resources/ResourceManager.hpp"
+
+#include <cstdint>
+#include <memory>
+
+// Draws a grid of packed 4x4 boards (see Bitboard) as thumbnails with a single instanced draw.
+// Boards are streamed every frame through a persistently mapped ring of three regions
+// guarded by fences, or by orphaning the buffer when GL 4.4 buffer storage is missing.
+class BoardWallRenderer {
+public:
+	BoardWallRenderer(size_t boardCount, TextureHandle atlas, ShaderProgramHandle shaderProgram);
+	~BoardWallRenderer();
+
+	BoardWallRenderer(const BoardWallRenderer&) = delete;
+	BoardWallRenderer& operator=(const BoardWallRenderer&) = delete;
+
+	void render(const uint64_t* boards, unsigned int width, unsigned int height);
+
+private:
+	static const int RING_SIZE = 3;
+
+	size_t m_boardCount;
+	TextureHandle m_atlas;
+	ShaderProgramHandle m_shaderProgram;
+
+	std::unique_ptr<VAO> m_VAO;
+	std::unique_ptr<VBO> m_quad;
+	std::unique_ptr<VBO> m_instances;
+
+	bool m_persistent;
+	void* m_mappedMemory = nullptr;
+	GLsync m_fences[RING_SIZE] = {};
+	int m_ringIndex = 0;
+
+	GLintptr upload(const uint64_t* boards); // returns the offset the boards were written at
+};
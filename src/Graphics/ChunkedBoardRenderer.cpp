@@ -0,0 +1,64 @@
+#include "ChunkedBoardRenderer.hpp"
+
+#include <algorithm>
+
+ChunkedBoardRenderer::ChunkedBoardRenderer(int boardSize, int chunkSize, TextureHandle atlas, ShaderProgramHandle shaderProgram)
+	: m_boardSize(boardSize), m_chunkSize(chunkSize), m_atlas(atlas), m_shaderProgram(shaderProgram),
+	m_uploadBuffer(static_cast<size_t>(chunkSize) * chunkSize)
+{
+	m_quad.reset(new VBO(std::array<GLfloat, 8>{ 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f }));
+
+	for (int y = 0; y < boardSize; y += chunkSize)
+		for (int x = 0; x < boardSize; x += chunkSize) {
+			Chunk chunk;
+			chunk.x = x;
+			chunk.y = y;
+			chunk.width = std::min(chunkSize, boardSize - x);
+			chunk.height = std::min(chunkSize, boardSize - y);
+
+			chunk.vao.reset(new VAO());
+			chunk.vao->addBuffer(m_quad->getID());
+			chunk.instances.reset(new VBO(nullptr, chunk.width * chunk.height));
+			chunk.vao->addIntegerInstanceBuffer(chunk.instances->getID(), 1, GL_UNSIGNED_BYTE);
+			m_chunks.push_back(std::move(chunk));
+		}
+
+	VBO::unbind();
+	VAO::unbind();
+}
+
+void ChunkedBoardRenderer::uploadChunk(int chunkX, int chunkY, const uint8_t* cells) {
+	int chunksPerSide = (m_boardSize + m_chunkSize - 1) / m_chunkSize;
+	Chunk& chunk = m_chunks[chunkY * chunksPerSide + chunkX];
+
+	for (int row = 0; row < chunk.height; row++) {
+		const uint8_t* source = cells + static_cast<size_t>(chunk.y + row) * m_boardSize + chunk.x;
+		std::copy(source, source + chunk.width, m_uploadBuffer.begin() + row * chunk.width);
+	}
+	chunk.instances->update(0, m_uploadBuffer.data(), chunk.width * chunk.height);
+}
+
+void ChunkedBoardRenderer::render(const glm::mat4& projection, const glm::vec4& visibleArea) {
+	m_drawCalls = 0;
+
+	const Texture* texture = ResourceManager::getTexture(m_atlas);
+	ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(m_shaderProgram);
+	if (!texture || !shaderProgram) return;
+
+	shaderProgram->use();
+	shaderProgram->setInt("tex", 0);
+	shaderProgram->setMatrix4("projectionMat", projection);
+
+	for (const Chunk& chunk : m_chunks) {
+		if (chunk.x + chunk.width < visibleArea.x || chunk.x > visibleArea.z || chunk.y + chunk.height < visibleArea.y || chunk.y > visibleArea.w) continue;
+
+		shaderProgram->setVec2("chunkOrigin", glm::vec2(chunk.x, chunk.y));
+		shaderProgram->setInt("chunkWidth", chunk.width);
+		Renderer::renderInstanced(chunk.vao->getID(), *texture, *shaderProgram, chunk.width * chunk.height);
+		m_drawCalls++;
+	}
+}
+
+size_t ChunkedBoardRenderer::getDrawCalls() const {
+	return m_drawCalls;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "VAO.hpp"
+#include "VBO.hpp"
+#include "../Resources/ResourceManager.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Draws a square board of tile exponents with one instanced draw per visible chunk.
+// Each chunk keeps its own instance buffer, so only chunks that changed are re-uploaded.
+class ChunkedBoardRenderer {
+public:
+	ChunkedBoardRenderer(int boardSize, int chunkSize, TextureHandle atlas, ShaderProgramHandle shaderProgram);
+
+	ChunkedBoardRenderer(const ChunkedBoardRenderer&) = delete;
+	ChunkedBoardRenderer& operator=(const ChunkedBoardRenderer&) = delete;
+
+	void uploadChunk(int chunkX, int chunkY, const uint8_t* cells); // cells of the whole board, row by row
+	void render(const glm::mat4& projection, const glm::vec4& visibleArea); // area in cells: left, bottom, right, top
+
+	size_t getDrawCalls() const; // of the last render()
+
+private:
+	struct Chunk {
+		std::unique_ptr<VAO> vao;
+		std::unique_ptr<VBO> instances;
+		int x, y, width, height;
+	};
+
+	int m_boardSize;
+	int m_chunkSize;
+	TextureHandle m_atlas;
+	ShaderProgramHandle m_shaderProgram;
+
+	std::unique_ptr<VBO> m_quad;
+	std::vector<Chunk> m_chunks;
+	std::vector<uint8_t> m_uploadBuffer;
+	size_t m_drawCalls = 0;
+};
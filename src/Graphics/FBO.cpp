@@ -0,0 +1,29 @@
+#include "FBO.hpp"
+
+FBO::FBO() {
+	glGenFramebuffers(1, &m_ID);
+}
+
+FBO::~FBO() {
+	glDeleteFramebuffers(1, &m_ID);
+}
+
+GLuint FBO::getID() const {
+	return m_ID;
+}
+
+bool FBO::attachTexture(const Texture& texture) {
+	bind(m_ID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.getID(), 0);
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	unbind();
+	return complete;
+}
+
+void FBO::bind(const GLuint& id) {
+	glBindFramebuffer(GL_FRAMEBUFFER, id);
+}
+
+void FBO::unbind() {
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "Texture.hpp"
+
+class FBO {
+public:
+	FBO();
+	~FBO();
+
+	FBO(const FBO&) = delete;
+	FBO& operator=(const FBO&) = delete;
+
+	GLuint getID() const;
+	bool attachTexture(const Texture& texture);
+	static void bind(const GLuint& id);
+	static void unbind();
+
+private:
+	GLuint m_ID;
+};
@@ -0,0 +1,235 @@
+#include "FrameCapture.hpp"
+#include "../Utilities/FileSystem.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static const GLuint64 FENCE_TIMEOUT = 1000000000; // 1 s, then wait again
+
+static bool hasSuffix(const std::string& str, const std::string& suffix) {
+	return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+FrameCapture::FrameCapture(const std::string& path, unsigned int framesPerSecond)
+	: m_path(path), m_video(hasSuffix(path, ".y4m")), m_framesPerSecond(std::max(1u, framesPerSecond))
+{
+	if (!m_video && !FileSystem::createDirectories(m_path)) {
+		std::cerr << "Can't create capture directory: " << m_path << std::endl;
+	}
+	m_writer = std::thread(&FrameCapture::writerLoop, this);
+}
+
+FrameCapture::~FrameCapture() {
+	finish();
+	for (GLsync fence : m_fences) {
+		if (fence) glDeleteSync(fence);
+	}
+}
+
+void FrameCapture::captureFrame(GLsizei width, GLsizei height) {
+	if (m_width == 0) { // even sizes keep the 4:2:0 chroma planes simple
+		m_width = width & ~1;
+		m_height = height & ~1;
+		if (m_width == 0 || m_height == 0) return;
+
+		for (int i = 0; i < RING_SIZE; i++) {
+			m_buffers[i].reset(new PBO(GLsizeiptr(m_width) * m_height * 4));
+		}
+		m_firstCapture = Clock::now();
+	}
+
+	while (!m_inFlight.empty()) { // hand over everything the GPU has already finished
+		GLenum status = glClientWaitSync(m_fences[m_inFlight.front()], 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+		collect(m_inFlight.front());
+	}
+	if (m_inFlight.size() == RING_SIZE) collect(m_inFlight.front()); // the GPU is a whole ring behind, only now do we wait
+
+	int slot = m_nextSlot;
+	PBO::bind(m_buffers[slot]->getID());
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	PBO::unbind();
+	m_fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_captureTimes[slot] = Clock::now();
+
+	m_inFlight.push_back(slot);
+	m_nextSlot = (slot + 1) % RING_SIZE;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_stats.captured++;
+}
+
+void FrameCapture::collect(int slot) {
+	m_inFlight.pop_front();
+
+	GLenum status;
+	do {
+		status = glClientWaitSync(m_fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+	} while (status == GL_TIMEOUT_EXPIRED);
+	glDeleteSync(m_fences[slot]);
+	m_fences[slot] = nullptr;
+
+	std::unique_ptr<Frame> frame;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_queue.size() >= MAX_QUEUED_FRAMES) {
+			m_stats.dropped++;
+			return;
+		}
+		if (!m_freeFrames.empty()) {
+			frame = std::move(m_freeFrames.back());
+			m_freeFrames.pop_back();
+		}
+	}
+	if (!frame) frame.reset(new Frame());
+
+	frame->index = m_nextIndex++;
+	frame->seconds = std::chrono::duration<double>(m_captureTimes[slot] - m_firstCapture).count();
+	frame->pixels.resize(size_t(m_buffers[slot]->getSize()));
+	const void* data = m_buffers[slot]->map();
+	if (data) std::memcpy(frame->pixels.data(), data, frame->pixels.size());
+	PBO::unmap();
+	if (!data) return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(std::move(frame));
+	}
+	m_condition.notify_one();
+}
+
+void FrameCapture::finish() {
+	if (!m_writer.joinable()) return;
+
+	while (!m_inFlight.empty()) {
+		collect(m_inFlight.front());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_finishing = true;
+	}
+	m_condition.notify_one();
+	m_writer.join();
+
+	if (m_videoFile) {
+		double seconds = std::chrono::duration<double>(Clock::now() - m_firstCapture).count(); // up to the end of the recording
+		repeatVideoFrame(static_cast<uint64_t>(seconds * m_framesPerSecond + 0.5));
+		std::fclose(m_videoFile);
+		m_videoFile = nullptr;
+	}
+}
+
+FrameCapture::Stats FrameCapture::getStats() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_stats;
+}
+
+void FrameCapture::writerLoop() {
+	for (;;) {
+		std::unique_ptr<Frame> frame;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this] { return !m_queue.empty() || m_finishing; });
+			if (m_queue.empty()) return;
+			frame = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		bool written = writeFrame(*frame);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (written) m_stats.written++;
+		m_freeFrames.push_back(std::move(frame));
+	}
+}
+
+bool FrameCapture::writeFrame(Frame& frame) {
+	size_t stride = size_t(m_width) * 4; // GL reads rows bottom-up, both formats want them top-down
+	std::vector<unsigned char> row(stride);
+	for (GLsizei y = 0; y < m_height / 2; y++) {
+		unsigned char* top = &frame.pixels[y * stride];
+		unsigned char* bottom = &frame.pixels[(m_height - 1 - y) * stride];
+		std::memcpy(row.data(), top, stride);
+		std::memcpy(top, bottom, stride);
+		std::memcpy(bottom, row.data(), stride);
+	}
+
+	return m_video ? writeY4M(frame) : writePNG(frame);
+}
+
+bool FrameCapture::writePNG(const Frame& frame) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "/frame_%06llu.png", static_cast<unsigned long long>(frame.index));
+	std::string path = m_path + name;
+
+	if (!stbi_write_png(path.c_str(), m_width, m_height, 4, frame.pixels.data(), m_width * 4)) {
+		std::cerr << "Can't write captured frame: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool FrameCapture::repeatVideoFrame(uint64_t untilFrame) {
+	for (; m_videoFrames > 0 && m_videoFrames < untilFrame; m_videoFrames++) { // the screen did not change meanwhile
+		std::fputs("FRAME\n", m_videoFile);
+		if (std::fwrite(m_planes.data(), 1, m_planes.size(), m_videoFile) != m_planes.size()) return false;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.repeated++;
+	}
+	return true;
+}
+
+bool FrameCapture::writeY4M(const Frame& frame) {
+	if (!m_videoFile) {
+		m_videoFile = std::fopen(m_path.c_str(), "wb");
+		if (!m_videoFile) {
+			std::cerr << "Can't open capture file: " << m_path << std::endl;
+			return false;
+		}
+		std::fprintf(m_videoFile, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n", m_width, m_height, m_framesPerSecond);
+	}
+
+	uint64_t videoFrame = static_cast<uint64_t>(frame.seconds * m_framesPerSecond + 0.5);
+	if (m_videoFrames > 0 && videoFrame < m_videoFrames) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stats.skipped++;
+		return false;
+	}
+	if (!repeatVideoFrame(videoFrame)) return false;
+
+	// BT.601 studio range, chroma from the average of each 2x2 block
+	size_t lumaSize = size_t(m_width) * m_height;
+	size_t chromaSize = lumaSize / 4;
+	m_planes.resize(lumaSize + chromaSize * 2);
+	unsigned char* yPlane = m_planes.data();
+	unsigned char* uPlane = yPlane + lumaSize;
+	unsigned char* vPlane = uPlane + chromaSize;
+
+	for (size_t i = 0; i < lumaSize; i++) {
+		const unsigned char* p = &frame.pixels[i * 4];
+		yPlane[i] = static_cast<unsigned char>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+	}
+
+	size_t stride = size_t(m_width) * 4;
+	for (GLsizei y = 0; y < m_height; y += 2) {
+		for (GLsizei x = 0; x < m_width; x += 2) {
+			const unsigned char* p = &frame.pixels[y * stride + x * 4];
+			int r = (p[0] + p[4] + p[stride] + p[stride + 4]) / 4;
+			int g = (p[1] + p[5] + p[stride + 1] + p[stride + 5]) / 4;
+			int b = (p[2] + p[6] + p[stride + 2] + p[stride + 6]) / 4;
+
+			size_t c = (y / 2) * (m_width / 2) + x / 2;
+			uPlane[c] = static_cast<unsigned char>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			vPlane[c] = static_cast<unsigned char>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+
+	std::fputs("FRAME\n", m_videoFile);
+	m_videoFrames = std::max(m_videoFrames, videoFrame) + 1;
+	return std::fwrite(m_planes.data(), 1, m_planes.size(), m_videoFile) == m_planes.size();
+}
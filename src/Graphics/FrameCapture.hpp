@@ -0,0 +1,89 @@
+#pragma once
+
+#include "glad/glad.h"
+#include "PBO.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records presented frames without stalling the renderer. glReadPixels goes into a ring
+// of pixel buffers guarded by fences, a buffer is mapped only once its fence has passed,
+// and a writer thread encodes the frames: a ".y4m" path becomes one raw video file,
+// any other path a directory of numbered PNG images. The frame size is fixed by the
+// first captured frame. The video keeps wall-clock time: the renderer only presents
+// frames that changed, so the last frame is repeated over the gaps, and a frame landing
+// on a slot already written is skipped. GL calls happen in captureFrame() and finish(),
+// so both belong on the thread that owns the context.
+class FrameCapture {
+public:
+	struct Stats {
+		uint64_t captured = 0;
+		uint64_t written = 0;
+		uint64_t dropped = 0; // the writer fell too far behind
+		uint64_t repeated = 0; // video frames filled with the previous frame
+		uint64_t skipped = 0; // captured faster than the video's frame rate
+	};
+
+	FrameCapture(const std::string& path, unsigned int framesPerSecond);
+	~FrameCapture(); // finish() must have run while a context was current
+
+	FrameCapture(const FrameCapture&) = delete;
+	FrameCapture& operator=(const FrameCapture&) = delete;
+
+	void captureFrame(GLsizei width, GLsizei height); // after rendering, before the swap
+	void finish(); // collects frames still in flight and waits for the writer
+	Stats getStats() const;
+
+private:
+	static const int RING_SIZE = 3;
+	static const size_t MAX_QUEUED_FRAMES = 64;
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct Frame {
+		uint64_t index;
+		double seconds; // since the first captured frame
+		std::vector<unsigned char> pixels; // RGBA, rows bottom-up as read back
+	};
+
+	void collect(int slot);
+	void writerLoop();
+	bool writeFrame(Frame& frame);
+	bool writePNG(const Frame& frame);
+	bool writeY4M(const Frame& frame);
+	bool repeatVideoFrame(uint64_t untilFrame); // the last one, up to that video frame
+
+	std::string m_path;
+	bool m_video;
+	unsigned int m_framesPerSecond;
+	GLsizei m_width = 0;
+	GLsizei m_height = 0;
+
+	std::unique_ptr<PBO> m_buffers[RING_SIZE];
+	GLsync m_fences[RING_SIZE] = {};
+	Clock::time_point m_captureTimes[RING_SIZE];
+	Clock::time_point m_firstCapture;
+	std::deque<int> m_inFlight; // ring slots in capture order
+	int m_nextSlot = 0;
+	uint64_t m_nextIndex = 0;
+
+	std::FILE* m_videoFile = nullptr;
+	uint64_t m_videoFrames = 0; // written to the file, repeats included
+	std::vector<unsigned char> m_planes; // Y, U and V planes of one video frame
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<std::unique_ptr<Frame>> m_queue;
+	std::vector<std::unique_ptr<Frame>> m_freeFrames;
+	bool m_finishing = false;
+	Stats m_stats;
+	std::thread m_writer;
+};
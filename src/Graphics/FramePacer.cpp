@@ -0,0 +1,91 @@
+#include "FramePacer.hpp"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+static const std::chrono::nanoseconds INITIAL_SPIN_MARGIN(2000000);
+static const std::chrono::nanoseconds MIN_SPIN_MARGIN(200000);
+static const std::chrono::nanoseconds MAX_SPIN_MARGIN(20000000); // coarse timers end up spinning most of the frame
+
+FramePacer::FramePacer(EMode mode, double targetFps) : m_mode(mode), m_targetFps(targetFps), m_spinMargin(INITIAL_SPIN_MARGIN) {
+    if (m_targetFps <= 0.0) m_targetFps = 60.0;
+    m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFps));
+    m_deadline = Clock::now() + m_period;
+}
+
+void FramePacer::applySwapInterval() const {
+    glfwSwapInterval(m_mode == EMode::VSYNC ? 1 : 0);
+}
+
+void FramePacer::frameFinished() {
+    if (m_mode == EMode::CAPPED) {
+        Clock::time_point now = Clock::now();
+        if (now > m_deadline + m_period) m_deadline = now; // fell behind, do not rush to catch up
+        else waitUntil(m_deadline);
+        m_deadline += m_period;
+    }
+
+    Clock::time_point now = Clock::now();
+    if (m_hasLastFrame) recordFrameTime(std::chrono::duration<double, std::milli>(now - m_lastFrame).count());
+    m_lastFrame = now;
+    m_hasLastFrame = true;
+}
+
+void FramePacer::pause() {
+    m_hasLastFrame = false;
+    m_deadline = Clock::now();
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) {
+    Clock::time_point wakeUp = deadline - m_spinMargin;
+    if (wakeUp > Clock::now()) {
+        std::this_thread::sleep_until(wakeUp);
+
+        // keep the margin a little above the worst recent oversleep, shrink it slowly otherwise
+        std::chrono::nanoseconds overslept = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - wakeUp);
+        if (overslept * 2 > m_spinMargin) m_spinMargin = std::min(overslept * 2, MAX_SPIN_MARGIN);
+        else m_spinMargin = std::max(m_spinMargin - m_spinMargin / 64, MIN_SPIN_MARGIN);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordFrameTime(double milliseconds) {
+    if (m_stats.frames == 0) {
+        m_stats.minFrameTime = milliseconds;
+        m_stats.maxFrameTime = milliseconds;
+    }
+    else {
+        m_stats.minFrameTime = std::min(m_stats.minFrameTime, milliseconds);
+        m_stats.maxFrameTime = std::max(m_stats.maxFrameTime, milliseconds);
+    }
+
+    m_stats.frames++;
+    double delta = milliseconds - m_stats.meanFrameTime;
+    m_stats.meanFrameTime += delta / m_stats.frames;
+    m_sumOfSquares += delta * (milliseconds - m_stats.meanFrameTime);
+    m_stats.jitter = std::sqrt(m_sumOfSquares / m_stats.frames);
+}
+
+FramePacer::EMode FramePacer::getMode() const {
+    return m_mode;
+}
+
+double FramePacer::getTargetFps() const {
+    return m_targetFps;
+}
+
+FramePacer::Stats FramePacer::getStats() const {
+    return m_stats;
+}
+
+void FramePacer::resetStats() {
+    m_stats = Stats();
+    m_sumOfSquares = 0.0;
+    m_hasLastFrame = false;
+}
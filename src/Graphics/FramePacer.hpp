@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Paces buffer swaps. VSYNC leaves it to the driver, CAPPED sleeps towards the next
+// frame deadline and spins the last stretch, UNLIMITED swaps as fast as possible.
+// Frame times between consecutive presented frames are collected for jitter stats.
+class FramePacer {
+public:
+    enum class EMode { VSYNC, CAPPED, UNLIMITED };
+
+    struct Stats {
+        uint64_t frames = 0;
+        double meanFrameTime = 0.0; // milliseconds
+        double minFrameTime = 0.0;
+        double maxFrameTime = 0.0;
+        double jitter = 0.0; // standard deviation of the frame time
+    };
+
+    FramePacer(EMode mode = EMode::VSYNC, double targetFps = 60.0);
+
+    void applySwapInterval() const; // on the thread that holds the context
+    void frameFinished(); // right after the swap
+    void pause(); // the loop is going idle, the next frame time must not include the wait
+
+    EMode getMode() const;
+    double getTargetFps() const;
+    Stats getStats() const;
+    void resetStats();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void waitUntil(Clock::time_point deadline);
+    void recordFrameTime(double milliseconds);
+
+    EMode m_mode;
+    double m_targetFps;
+    Clock::duration m_period;
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastFrame;
+    bool m_hasLastFrame = false;
+    std::chrono::nanoseconds m_spinMargin; // how early the sleep ends, follows the measured oversleep
+
+    Stats m_stats;
+    double m_sumOfSquares = 0.0; // running sum of squared deviations, Welford's method
+};
@@ -0,0 +1,44 @@
+#include "GLExtensions.hpp"
+
+GLExtensions::GetProgramBinaryProc GLExtensions::getProgramBinary = nullptr;
+GLExtensions::ProgramBinaryProc GLExtensions::programBinary = nullptr;
+GLExtensions::ProgramParameteriProc GLExtensions::programParameteri = nullptr;
+GLExtensions::BufferStorageProc GLExtensions::bufferStorage = nullptr;
+
+void GLExtensions::load(GLADloadproc loadProc) {
+	if (isVersionAtLeast(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+		getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(loadProc("glGetProgramBinary"));
+		programBinary = reinterpret_cast<ProgramBinaryProc>(loadProc("glProgramBinary"));
+		programParameteri = reinterpret_cast<ProgramParameteriProc>(loadProc("glProgramParameteri"));
+	}
+	if (isVersionAtLeast(4, 4) || hasExtension("GL_ARB_buffer_storage")) {
+		bufferStorage = reinterpret_cast<BufferStorageProc>(loadProc("glBufferStorage"));
+	}
+}
+
+bool GLExtensions::hasExtension(const std::string& name) {
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; i++) {
+		const GLubyte* extension = glGetStringi(GL_EXTENSIONS, i);
+		if (extension && name == reinterpret_cast<const char*>(extension)) return true;
+	}
+	return false;
+}
+
+bool GLExtensions::isVersionAtLeast(int major, int minor) {
+	return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+bool GLExtensions::hasProgramBinary() {
+	if (!getProgramBinary || !programBinary || !programParameteri) return false;
+
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+
+bool GLExtensions::hasBufferStorage() {
+	return bufferStorage != nullptr;
+}
\ No newline at end of file
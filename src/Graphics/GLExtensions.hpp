@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+// Entry points newer than the GL 3.3 core glad was generated for.
+// Pointers stay null when neither the context version nor an extension provides them.
+class GLExtensions {
+public:
+	typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+	typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+	typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+	typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+	static GetProgramBinaryProc getProgramBinary;
+	static ProgramBinaryProc programBinary;
+	static ProgramParameteriProc programParameteri;
+	static BufferStorageProc bufferStorage;
+
+	static void load(GLADloadproc loadProc);
+	static bool hasExtension(const std::string& name);
+	static bool isVersionAtLeast(int major, int minor);
+	static bool hasProgramBinary();
+	static bool hasBufferStorage();
+
+private:
+	GLExtensions() = delete;
+};
@@ -0,0 +1,45 @@
+#include "PBO.hpp"
+
+PBO::PBO(const GLsizeiptr size) : m_size(size) {
+	glGenBuffers(1, &m_ID);
+	bind(m_ID);
+	glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+	unbind();
+}
+
+PBO::~PBO() {
+	glDeleteBuffers(1, &m_ID);
+}
+
+GLuint PBO::getID() const {
+	return m_ID;
+}
+
+GLsizeiptr PBO::getSize() const {
+	return m_size;
+}
+
+void PBO::resize(const GLsizeiptr size) {
+	m_size = size;
+	bind(m_ID);
+	glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+	unbind();
+}
+
+const void* PBO::map() {
+	bind(m_ID);
+	return glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_size, GL_MAP_READ_BIT);
+}
+
+void PBO::unmap() {
+	glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	unbind();
+}
+
+void PBO::bind(const GLuint& id) {
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+}
+
+void PBO::unbind() {
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
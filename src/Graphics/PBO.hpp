@@ -0,0 +1,24 @@
+#pragma once
+
+#include "glad/glad.h"
+
+class PBO { // pixel pack buffer, target of asynchronous glReadPixels
+public:
+	PBO(const GLsizeiptr size);
+	~PBO();
+
+	PBO(const PBO&) = delete;
+	PBO& operator=(const PBO&) = delete;
+
+	GLuint getID() const;
+	GLsizeiptr getSize() const;
+	void resize(const GLsizeiptr size);
+	const void* map(); // bound buffer, read only, until unmap()
+	static void unmap();
+	static void bind(const GLuint& id);
+	static void unbind();
+
+private:
+	GLuint m_ID;
+	GLsizeiptr m_size;
+};
@@ -1,5 +1,7 @@
 #include "Renderer.hpp"
 
+FrameCapture* Renderer::m_frameCapture = nullptr;
+
 void Renderer::render(const GLuint& vao, const Texture& texture, const ShaderProgram& shader) {
 	shader.use();
 	VAO::bind(vao);
@@ -10,6 +12,16 @@ void Renderer::render(const GLuint& vao, const Texture& texture, const ShaderPro
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
+void Renderer::renderInstanced(const GLuint& vao, const Texture& texture, const ShaderProgram& shader, const GLsizei instanceCount) {
+	shader.use();
+	VAO::bind(vao);
+
+	glActiveTexture(GL_TEXTURE0);
+	texture.bind();
+
+	glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, instanceCount);
+}
+
 void Renderer::clearColor(float r, float g, float b, float a) {
 	glClearColor(r, g, b, a);
 }
@@ -21,3 +33,21 @@ void Renderer::clear() {
 void Renderer::viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height) {
 	glViewport(x, y, width, height);
 }
+
+void Renderer::setBlending(const bool enabled) {
+	if (enabled) {
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	else {
+		glDisable(GL_BLEND);
+	}
+}
+
+void Renderer::setFrameCapture(FrameCapture* capture) {
+	m_frameCapture = capture;
+}
+
+void Renderer::captureFrame(const GLsizei width, const GLsizei height) {
+	if (m_frameCapture) m_frameCapture->captureFrame(width, height);
+}
\ No newline at end of file
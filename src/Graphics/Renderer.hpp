@@ -3,14 +3,21 @@
 #include "ShaderProgram.hpp"
 #include "Texture.hpp"
 #include "Sprite.hpp"
+#include "FrameCapture.hpp"
 
 class Renderer {
 public:
     static void render(const GLuint& vao, const Texture& texture, const ShaderProgram& shader);
+    static void renderInstanced(const GLuint& vao, const Texture& texture, const ShaderProgram& shader, const GLsizei instanceCount);
     static void clearColor(float r, float g, float b, float a);
     static void clear();
     static void viewport(const GLint x, const GLint y, const GLsizei width, const GLsizei height);
+    static void setBlending(const bool enabled); // straight alpha
+    static void setFrameCapture(FrameCapture* capture); // nullptr stops capturing
+    static void captureFrame(const GLsizei width, const GLsizei height); // the frame about to be presented
 
 private:
+    static FrameCapture* m_frameCapture;
+
     Renderer() = delete;
 };
\ No newline at end of file
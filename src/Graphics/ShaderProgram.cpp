@@ -1,8 +1,30 @@
 #include "ShaderProgram.hpp"
+#include "../Utilities/FileSystem.hpp"
+#include "../Utilities/Hash.hpp"
+
+#include <cstring>
+#include <vector>
+
+const char* const ShaderProgram::BINARY_CACHE_DIRECTORY = "cache/shaders";
+
+static const char BINARY_MAGIC[4] = { 'G', 'P', 'R', 'B' };
+
+struct BinaryHeader {
+    char magic[4];
+    GLenum format;
+    GLsizei length;
+};
+
+ShaderProgram::ShaderProgram(const std::string& vertexShaderSourcePath, const std::string& fragmentShaderSourcePath)
+    : ShaderProgram(loadSources(vertexShaderSourcePath, fragmentShaderSourcePath)) {}
+
+ShaderProgram::ShaderProgram(const Sources& sources) {
+    const std::string& vertexShaderSource = sources.vertex;
+    const std::string& fragmentShaderSource = sources.fragment;
+
+    std::string cachePath = binaryCachePath(vertexShaderSource, fragmentShaderSource);
+    if (loadBinary(cachePath)) return;
 
-ShaderProgram::ShaderProgram(const std::string& vertexShaderSourcePath, const std::string& fragmentShaderSourcePath) {
-    std::string vertexShaderSource = load(vertexShaderSourcePath);
-    std::string fragmentShaderSource = load(fragmentShaderSourcePath);
     const char* vss_c_str = vertexShaderSource.c_str();
     const char* fss_c_str = fragmentShaderSource.c_str();
 
@@ -18,8 +40,8 @@ ShaderProgram::ShaderProgram(const std::string& vertexShaderSourcePath, const st
         glDeleteShader(vertexShaderID);
         std::cerr << "Fragment shader not created\n";
     }
-    else {
-        createShaderProgram(vertexShaderID, fragmentShaderID);
+    else if (createShaderProgram(vertexShaderID, fragmentShaderID)) {
+        saveBinary(cachePath);
     }
 }
 
@@ -45,6 +67,14 @@ GLuint ShaderProgram::getID() const {
     return m_ID;
 }
 
+size_t ShaderProgram::getBinarySize() const {
+    if (!GLExtensions::hasProgramBinary()) return 0;
+
+    GLint length = 0;
+    glGetProgramiv(m_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    return static_cast<size_t>(length);
+}
+
 void ShaderProgram::use() const {
     glUseProgram(m_ID);
 }
@@ -53,10 +83,25 @@ void ShaderProgram::setInt(const std::string& name, const GLint value) {
     glUniform1i(glGetUniformLocation(m_ID, name.c_str()), value);
 }
 
+void ShaderProgram::setFloat(const std::string& name, const GLfloat value) {
+    glUniform1f(glGetUniformLocation(m_ID, name.c_str()), value);
+}
+
+void ShaderProgram::setVec2(const std::string& name, const glm::vec2& vector) {
+    glUniform2fv(glGetUniformLocation(m_ID, name.c_str()), 1, glm::value_ptr(vector));
+}
+
 void ShaderProgram::setMatrix4(const std::string& name, const glm::mat4& matrix) {
     glUniformMatrix4fv(glGetUniformLocation(m_ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
+ShaderProgram::Sources ShaderProgram::loadSources(const std::string& vertexShaderSourcePath, const std::string& fragmentShaderSourcePath) {
+    Sources sources;
+    sources.vertex = load(vertexShaderSourcePath);
+    sources.fragment = load(fragmentShaderSourcePath);
+    return sources;
+}
+
 std::string ShaderProgram::load(const std::string& path) {
     std::ifstream file(path);
 
@@ -101,8 +146,11 @@ bool ShaderProgram::createShader(const char* shaderSource, GLenum shaderType, GL
     return true;
 }
 
-void ShaderProgram::createShaderProgram(GLuint& vertexShaderID, GLuint& fragmentShaderID) {
+bool ShaderProgram::createShaderProgram(GLuint& vertexShaderID, GLuint& fragmentShaderID) {
     m_ID = glCreateProgram();
+    if (GLExtensions::hasProgramBinary()) {
+        GLExtensions::programParameteri(m_ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glAttachShader(m_ID, vertexShaderID);
     glAttachShader(m_ID, fragmentShaderID);
     glLinkProgram(m_ID);
@@ -118,4 +166,58 @@ void ShaderProgram::createShaderProgram(GLuint& vertexShaderID, GLuint& fragment
 
     glDeleteShader(vertexShaderID);
     glDeleteShader(fragmentShaderID);
+    return success == GL_TRUE;
+}
+
+std::string ShaderProgram::binaryCachePath(const std::string& vertexShaderSource, const std::string& fragmentShaderSource) {
+    if (!GLExtensions::hasProgramBinary()) return "";
+
+    uint64_t hash = Hash::fnv1a(vertexShaderSource);
+    hash = Hash::fnv1a(fragmentShaderSource, hash);
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) { // a driver update invalidates the cache
+        const GLubyte* str = glGetString(name);
+        if (str) hash = Hash::fnv1a(std::string(reinterpret_cast<const char*>(str)), hash);
+    }
+    return std::string(BINARY_CACHE_DIRECTORY) + "/" + Hash::toHex(hash) + ".bin";
+}
+
+bool ShaderProgram::loadBinary(const std::string& path) {
+    std::vector<unsigned char> data;
+    if (path.empty() || !FileSystem::readFile(path, data) || data.size() < sizeof(BinaryHeader)) return false;
+
+    BinaryHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || header.length <= 0 || data.size() != sizeof(header) + header.length) return false;
+
+    m_ID = glCreateProgram();
+    GLExtensions::programBinary(m_ID, header.format, data.data() + sizeof(header), header.length);
+
+    GLint success;
+    glGetProgramiv(m_ID, GL_LINK_STATUS, &success);
+    if (!success) { // driver rejected the binary, compile from source
+        glDeleteProgram(m_ID);
+        m_ID = 0;
+        return false;
+    }
+    return true;
+}
+
+void ShaderProgram::saveBinary(const std::string& path) {
+    if (path.empty()) return;
+
+    GLint length = 0;
+    glGetProgramiv(m_ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    BinaryHeader header;
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    std::vector<unsigned char> data(sizeof(header) + length);
+    GLExtensions::getProgramBinary(m_ID, length, &header.length, &header.format, data.data() + sizeof(header));
+    if (header.length <= 0) return;
+
+    data.resize(sizeof(header) + header.length);
+    std::memcpy(data.data(), &header, sizeof(header));
+    if (!FileSystem::createDirectories(BINARY_CACHE_DIRECTORY) || !FileSystem::writeFile(path, data.data(), data.size())) {
+        std::cerr << "Can't write shader cache: " << path << std::endl;
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glad/glad.h>
+#include "GLExtensions.hpp"
 
 #include <iostream>
 #include <string>
@@ -12,7 +13,13 @@
 
 class ShaderProgram { //   
 public:
+    struct Sources {
+        std::string vertex;
+        std::string fragment;
+    };
+
     ShaderProgram(const std::string& vertexShaderSourcePath, const std::string& fragmentShaderSourcePath);
+    explicit ShaderProgram(const Sources& sources);
     ~ShaderProgram();
 
     ShaderProgram() = delete;
@@ -23,14 +30,25 @@ public:
     ShaderProgram& operator=(ShaderProgram&&) noexcept;
 
     GLuint getID() const;
+    size_t getBinarySize() const;
     void use() const;
     void setInt(const std::string& name, const GLint value);
+    void setFloat(const std::string& name, const GLfloat value);
+    void setVec2(const std::string& name, const glm::vec2& vector);
     void setMatrix4(const std::string& name, const glm::mat4& matrix);
 
+    static Sources loadSources(const std::string& vertexShaderSourcePath, const std::string& fragmentShaderSourcePath); // no GL calls, safe off the GL thread
+
+    static const char* const BINARY_CACHE_DIRECTORY;
+
 private:
     GLuint m_ID = 0;
 
-    std::string load(const std::string& path);
+    static std::string load(const std::string& path);
     bool createShader(const char* shaderSource, GLenum shaderType, GLuint& shaderID);
-    void createShaderProgram(GLuint& vertexShaderID, GLuint& fragmentShaderID);
+    bool createShaderProgram(GLuint& vertexShaderID, GLuint& fragmentShaderID);
+
+    std::string binaryCachePath(const std::string& vertexShaderSource, const std::string& fragmentShaderSource);
+    bool loadBinary(const std::string& path);
+    void saveBinary(const std::string& path);
 };
\ No newline at end of file
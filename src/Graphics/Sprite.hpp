@@ -3,6 +3,7 @@
 #include "Renderer.hpp"
 #include "VAO.hpp"
 #include "VBO.hpp"
+#include "../Resources/ResourceManager.hpp"
 
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,12 +13,12 @@
 
 class Sprite {
 public:
-	Sprite(std::shared_ptr<Texture> pTexture, std::shared_ptr<ShaderProgram> pShaderProgram,
+	Sprite(TextureHandle texture, ShaderProgramHandle shaderProgram,
 		const glm::vec2& position = glm::vec2(0.f),
 		const glm::vec2& size = glm::vec2(1.f),
 		const float rotation = 0.f,
-		std::array<float, 8>& userTexCoords = std::array<float, 8>{0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f},
-		std::array<float, 8>& userVertCoords = std::array<float, 8>{0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f}
+		const std::array<float, 8>& userTexCoords = std::array<float, 8>{0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f},
+		const std::array<float, 8>& userVertCoords = std::array<float, 8>{0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f}
 	);
 	~Sprite() = default;
 
@@ -30,13 +31,13 @@ public:
 	void setRotation(const float rotation);
 
 private:
-	std::shared_ptr<Texture> m_pTexture;
-	std::shared_ptr<ShaderProgram> m_pShaderProgram;
+	TextureHandle m_texture;
+	ShaderProgramHandle m_shaderProgram;
 	glm::vec2 m_position;
 	glm::vec2 m_size;
 	float m_rotation;
 
-	std::shared_ptr<VAO> m_pVAO;
+	std::unique_ptr<VAO> m_pVAO;
 	GLuint m_VAO;
-	std::vector <std::shared_ptr<VBO>> m_pVBO_vector;
+	std::vector <std::unique_ptr<VBO>> m_pVBO_vector;
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "TextRenderer.hpp"
+#include "BitmapFont.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+static GLuint packColor(const glm::vec4& color) {
+	GLuint packed = 0;
+	for (int i = 3; i >= 0; i--) {
+		packed = packed << 8 | static_cast<GLuint>(std::min(std::max(color[i], 0.f), 1.f) * 255.f + 0.5f);
+	}
+	return packed;
+}
+
+TextRenderer::TextRenderer(ShaderProgramHandle shaderProgram) : m_shaderProgram(shaderProgram) {
+	m_atlas = ResourceManager::createTexture(BitmapFont::buildDistanceFieldAtlas(), GL_LINEAR);
+
+	m_quad.reset(new VBO(std::array<GLfloat, 8>{ 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f }));
+	m_instances.reset(new VBO(nullptr, 0));
+
+	m_vao.reset(new VAO());
+	m_vao->addBuffer(m_quad->getID());
+	m_vao->addInstanceBuffer(m_instances->getID(), 4, sizeof(Glyph), offsetof(Glyph, x));
+	m_vao->addIntegerInstanceBuffer(m_instances->getID(), 2, GL_UNSIGNED_INT, sizeof(Glyph), offsetof(Glyph, index));
+	m_vao->addInstanceBuffer(m_instances->getID(), 2, sizeof(Glyph), offsetof(Glyph, slideX));
+
+	VBO::unbind();
+	VAO::unbind();
+}
+
+void TextRenderer::clear() {
+	m_glyphs.clear();
+	m_uploaded = false;
+}
+
+void TextRenderer::addText(const std::string& text, const glm::vec2& position, float height, const glm::vec4& color, const glm::vec2& slide) {
+	float scale = height / BitmapFont::GLYPH_HEIGHT; // screen units per font pixel
+	GLuint packedColor = packColor(color);
+
+	float x = position.x;
+	for (char c : text) {
+		int index = BitmapFont::glyphIndex(c);
+		if (index > 0) { // space and unknown characters only advance
+			Glyph glyph;
+			glyph.x = x - scale;
+			glyph.y = position.y - scale;
+			glyph.width = BitmapFont::CELL_SIZE * scale;
+			glyph.height = BitmapFont::CELL_SIZE * scale;
+			glyph.index = static_cast<GLuint>(index);
+			glyph.color = packedColor;
+			glyph.slideX = slide.x;
+			glyph.slideY = slide.y;
+			m_glyphs.push_back(glyph);
+		}
+		x += BitmapFont::ADVANCE * scale;
+	}
+	m_uploaded = false;
+}
+
+float TextRenderer::measure(const std::string& text, float height) const {
+	if (text.empty()) return 0.f;
+	return (text.size() * BitmapFont::ADVANCE - (BitmapFont::ADVANCE - BitmapFont::GLYPH_WIDTH)) * height / BitmapFont::GLYPH_HEIGHT;
+}
+
+void TextRenderer::render(const glm::mat4& projection, float time, float speed) {
+	const Texture* texture = ResourceManager::getTexture(m_atlas);
+	ShaderProgram* shaderProgram = ResourceManager::getShaderProgram(m_shaderProgram);
+	if (!texture || !shaderProgram || m_glyphs.empty()) return;
+
+	if (!m_uploaded) {
+		GLsizeiptr size = static_cast<GLsizeiptr>(m_glyphs.size() * sizeof(Glyph));
+		if (m_glyphs.size() > m_capacity) { // grow to the next power of two, then keep reusing the storage
+			m_capacity = 1;
+			while (m_capacity < m_glyphs.size()) m_capacity <<= 1;
+			m_instances->orphan(static_cast<GLsizeiptr>(m_capacity * sizeof(Glyph)), GL_DYNAMIC_DRAW);
+		}
+		m_instances->update(0, m_glyphs.data(), size);
+		m_uploaded = true;
+	}
+
+	shaderProgram->use();
+	shaderProgram->setInt("tex", 0);
+	shaderProgram->setMatrix4("projectionMat", projection);
+	shaderProgram->setFloat("time", time);
+	shaderProgram->setFloat("speed", speed);
+	shaderProgram->setInt("atlasColumns", BitmapFont::ATLAS_COLUMNS);
+	shaderProgram->setVec2("atlasCellSize", glm::vec2(1.f / BitmapFont::ATLAS_COLUMNS, 1.f / ((BitmapFont::GLYPH_COUNT + BitmapFont::ATLAS_COLUMNS - 1) / BitmapFont::ATLAS_COLUMNS)));
+
+	Renderer::setBlending(true);
+	Renderer::renderInstanced(m_vao->getID(), *texture, *shaderProgram, static_cast<GLsizei>(m_glyphs.size()));
+	Renderer::setBlending(false);
+}
+
+size_t TextRenderer::getGlyphCount() const {
+	return m_glyphs.size();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "VAO.hpp"
+#include "VBO.hpp"
+#include "../Resources/ResourceManager.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Batches text into one instanced draw over a signed distance field glyph atlas, so any
+// size stays sharp from the same texture. Strings are queued between clear() and
+// render(); the instance buffer is reused and only re-uploaded when the batch changed,
+// so static text costs one draw call per frame and nothing else. Text can be given a
+// slide to follow an animated tile: it starts that far back and catches up at the
+// speed passed to render(), the same way vTiles moves the tiles.
+class TextRenderer {
+public:
+	TextRenderer(ShaderProgramHandle shaderProgram); // GL thread, builds the atlas
+
+	TextRenderer(const TextRenderer&) = delete;
+	TextRenderer& operator=(const TextRenderer&) = delete;
+
+	void clear();
+	void addText(const std::string& text, const glm::vec2& position, float height, const glm::vec4& color, const glm::vec2& slide = glm::vec2(0.f)); // position is the bottom-left of the first glyph, where it ends up
+	float measure(const std::string& text, float height) const;
+	void render(const glm::mat4& projection, float time = 0.f, float speed = 0.f); // time since the slide started, speed in projection units per second
+
+	size_t getGlyphCount() const;
+
+private:
+	struct Glyph {
+		GLfloat x, y, width, height; // the whole atlas cell, padding included
+		GLuint index;
+		GLuint color; // RGBA8, red in the low byte
+		GLfloat slideX, slideY; // distance still to travel at time 0
+	};
+
+	TextureHandle m_atlas;
+	ShaderProgramHandle m_shaderProgram;
+
+	std::unique_ptr<VBO> m_quad;
+	std::unique_ptr<VBO> m_instances;
+	std::unique_ptr<VAO> m_vao;
+	std::vector<Glyph> m_glyphs;
+	size_t m_capacity = 0; // glyphs the instance buffer holds
+	bool m_uploaded = false;
+};
@@ -7,6 +7,23 @@ Texture::Texture(const std::string& texturePath, const unsigned int channels, co
 	if (errorCode != "0") std::cerr << "Can't create texture: " << texturePath << std::endl;
 }
 
+Texture::Texture(const TextureImage& image, const GLenum filter, const GLenum wrapmode)
+	: m_filter(filter), m_wrapmode(wrapmode)
+{
+	createTexture(image);
+}
+
+Texture::Texture(const unsigned int width, const unsigned int height, const GLenum filter, const GLenum wrapmode)
+	: m_filter(filter), m_wrapmode(wrapmode)
+{
+	TextureImage image;
+	image.width = width;
+	image.height = height;
+	image.channels = 4;
+	image.levels = 1;
+	createTexture(image);
+}
+
 Texture::~Texture() {
 	glDeleteTextures(1, &m_ID);
 }
@@ -41,35 +58,42 @@ GLuint Texture::getID() const {
 	return m_ID;
 }
 
-void Texture::bind() const {
-	glBindTexture(GL_TEXTURE_2D, m_ID);
+unsigned int Texture::getWidth() const {
+	return m_width;
 }
 
-std::string Texture::load(const std::string& path) {
-	int channels = 0;
-	int width = 0;
-	int height = 0;
-
-	stbi_set_flip_vertically_on_load(true);
+unsigned int Texture::getHeight() const {
+	return m_height;
+}
 
-	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 0);
+void Texture::bind() const {
+	glBindTexture(GL_TEXTURE_2D, m_ID);
+}
 
+void Texture::resize(const unsigned int width, const unsigned int height) {
 	m_width = width;
 	m_height = height;
 
-	if (!pixels) {
+	glBindTexture(GL_TEXTURE_2D, m_ID);
+	glTexImage2D(GL_TEXTURE_2D, 0, m_mode, m_width, m_height, 0, m_mode, GL_UNSIGNED_BYTE, nullptr);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+std::string Texture::load(const std::string& path) {
+	TextureImage image;
+	if (!image.loadFromFile(path)) {
+		m_width = m_height = 0;
 		std::cerr << "Can't load texture: " << path << std::endl;
 		return "-1";
 	}
 
-	createTexture(channels, pixels);
-	stbi_image_free(pixels);
+	createTexture(image);
 
 	return "0";
 }
 
-void Texture::createTexture(const unsigned int channels, const unsigned char* pixels) {
-	switch (channels) {
+void Texture::createTexture(const TextureImage& image) {
+	switch (image.channels) {
 	case 3:
 		m_mode = GL_RGB;
 		break;
@@ -80,18 +104,32 @@ void Texture::createTexture(const unsigned int channels, const unsigned char* pi
 		m_mode = GL_RGBA;
 		break;
 	}
+	m_width = image.width;
+	m_height = image.height;
 
 	glGenTextures(1, &m_ID);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, m_ID);
-	glTexImage2D(GL_TEXTURE_2D, 0, m_mode, m_width, m_height, 0, m_mode, GL_UNSIGNED_BYTE, pixels);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	for (unsigned int level = 0; level < image.levels; level++) {
+		const unsigned char* pixels = image.pixels.empty() ? nullptr : image.pixels.data() + image.levelOffset(level);
+		glTexImage2D(GL_TEXTURE_2D, level, m_mode, image.levelWidth(level), image.levelHeight(level), 0, m_mode, GL_UNSIGNED_BYTE, pixels);
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, m_wrapmode);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, m_wrapmode);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_filter);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_filter);
 
-	glGenerateMipmap(GL_TEXTURE_2D);
+	bool mipmapFilter = m_filter != GL_NEAREST && m_filter != GL_LINEAR;
+	if (mipmapFilter && image.levels == 1) { // the container had no mip chain, build it here
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmapFilter ? image.levels - 1 : 0);
+	}
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "stb_image.h"
+#include "TextureImage.hpp"
 #include <glad/glad.h>
 
 #include <iostream>
@@ -12,6 +12,12 @@ public:
         const unsigned int channels = 4,
         const GLenum filter = GL_LINEAR,
         const GLenum wrapmode = GL_CLAMP_TO_EDGE);
+	Texture(const TextureImage& image,
+        const GLenum filter = GL_LINEAR,
+        const GLenum wrapmode = GL_CLAMP_TO_EDGE);
+	Texture(const unsigned int width, const unsigned int height, // empty RGBA, e.g. a render target
+        const GLenum filter = GL_LINEAR,
+        const GLenum wrapmode = GL_CLAMP_TO_EDGE);
     ~Texture();
     
     Texture() = delete;
@@ -22,7 +28,10 @@ public:
     Texture& operator=(Texture&&) noexcept;
 
     GLuint getID() const;
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
     void bind() const;
+    void resize(const unsigned int width, const unsigned int height); // contents become undefined
 
 private:
     GLuint m_ID = 0;
@@ -34,5 +43,5 @@ private:
     unsigned int m_height;
 
     std::string load(const std::string& path);
-    void createTexture(const unsigned int channels, const unsigned char* pixels);
+    void createTexture(const TextureImage& image);
 };
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "TextureImage.hpp"
+#include "../Utilities/FileSystem.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+const char* const TextureImage::CONTAINER_EXTENSION = ".tex";
+
+static const char CONTAINER_MAGIC[4] = { 'G', 'T', 'E', 'X' };
+
+bool TextureImage::loadFromFile(const std::string& path) {
+	return loadContainer(FileSystem::replaceExtension(path, CONTAINER_EXTENSION)) || loadPNG(path);
+}
+
+bool TextureImage::loadContainer(const std::string& path) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return false;
+	std::streamsize size = file.tellg();
+	file.seekg(0, std::ios::beg);
+
+	ContainerHeader header;
+	if (size < static_cast<std::streamsize>(sizeof(header)) || !file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (std::memcmp(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC)) != 0 || header.version != CONTAINER_VERSION) return false;
+	// Texture uploads 3 channels as RGB and anything else as RGBA, fewer would be read past their end
+	if (header.width == 0 || header.height == 0 || header.channels < 3 || header.channels > 4 || header.levels == 0 || header.levels > 32) return false;
+
+	width = header.width;
+	height = header.height;
+	channels = header.channels;
+	levels = header.levels;
+	if (static_cast<size_t>(size) != sizeof(header) + levelOffset(levels)) return false;
+
+	pixels.resize(levelOffset(levels)); // the payload goes straight into place
+	return file.read(reinterpret_cast<char*>(pixels.data()), static_cast<std::streamsize>(pixels.size())).good();
+}
+
+bool TextureImage::loadPNG(const std::string& path) {
+	int w = 0;
+	int h = 0;
+	int c = 0;
+	if (!stbi_info(path.c_str(), &w, &h, &c)) return false;
+
+	int requested = c < 3 ? 4 : 0; // gray goes to RGBA, Texture has no upload for 1 or 2 channels
+	unsigned char* data = stbi_load(path.c_str(), &w, &h, &c, requested);
+	if (!data) return false;
+
+	width = w;
+	height = h;
+	channels = requested ? requested : c;
+	levels = 1;
+	pixels.resize(levelSize(0));
+
+	size_t rowSize = static_cast<size_t>(width) * channels; // flip here, stbi's flip flag is global and not thread safe
+	for (unsigned int y = 0; y < height; y++) {
+		std::memcpy(pixels.data() + y * rowSize, data + (height - 1 - y) * rowSize, rowSize);
+	}
+	stbi_image_free(data);
+	return true;
+}
+
+bool TextureImage::saveContainer(const std::string& path) const {
+	ContainerHeader header;
+	std::memcpy(header.magic, CONTAINER_MAGIC, sizeof(CONTAINER_MAGIC));
+	header.version = CONTAINER_VERSION;
+	header.width = width;
+	header.height = height;
+	header.channels = channels;
+	header.levels = levels;
+
+	std::vector<unsigned char> data(sizeof(header) + pixels.size());
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), pixels.data(), pixels.size());
+	return FileSystem::writeFile(path, data.data(), data.size());
+}
+
+void TextureImage::generateMipmaps() { // 2x2 box filter down to 1x1
+	pixels.resize(levelOffset(1));
+	levels = 1;
+
+	while (levelWidth(levels - 1) > 1 || levelHeight(levels - 1) > 1) {
+		unsigned int srcLevel = levels - 1;
+		unsigned int srcWidth = levelWidth(srcLevel);
+		unsigned int srcHeight = levelHeight(srcLevel);
+		size_t srcOffset = levelOffset(srcLevel);
+
+		levels++;
+		unsigned int dstWidth = levelWidth(srcLevel + 1);
+		unsigned int dstHeight = levelHeight(srcLevel + 1);
+		size_t dstOffset = pixels.size();
+		pixels.resize(dstOffset + levelSize(srcLevel + 1));
+
+		for (unsigned int y = 0; y < dstHeight; y++)
+			for (unsigned int x = 0; x < dstWidth; x++)
+				for (unsigned int c = 0; c < channels; c++) {
+					unsigned int x0 = std::min(2 * x, srcWidth - 1), x1 = std::min(2 * x + 1, srcWidth - 1);
+					unsigned int y0 = std::min(2 * y, srcHeight - 1), y1 = std::min(2 * y + 1, srcHeight - 1);
+					unsigned int sum = pixels[srcOffset + (y0 * srcWidth + x0) * channels + c]
+						+ pixels[srcOffset + (y0 * srcWidth + x1) * channels + c]
+						+ pixels[srcOffset + (y1 * srcWidth + x0) * channels + c]
+						+ pixels[srcOffset + (y1 * srcWidth + x1) * channels + c];
+					pixels[dstOffset + (y * dstWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+	}
+}
+
+size_t TextureImage::levelOffset(unsigned int level) const {
+	size_t offset = 0;
+	for (unsigned int l = 0; l < level; l++) offset += levelSize(l);
+	return offset;
+}
+
+size_t TextureImage::levelSize(unsigned int level) const {
+	return static_cast<size_t>(levelWidth(level)) * levelHeight(level) * channels;
+}
+
+unsigned int TextureImage::levelWidth(unsigned int level) const {
+	return std::max(1u, width >> level);
+}
+
+unsigned int TextureImage::levelHeight(unsigned int level) const {
+	return std::max(1u, height >> level);
+}
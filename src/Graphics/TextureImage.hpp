@@ -0,0 +1,43 @@
+#pragma once
+
+#include "stb_image.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CPU-side pixels of a texture. Levels are stored one after another, level 0 first,
+// rows bottom to top so they can go to glTexImage2D as is.
+class TextureImage {
+public:
+	static const char* const CONTAINER_EXTENSION;
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int channels = 0;
+	unsigned int levels = 0;
+	std::vector<unsigned char> pixels;
+
+	bool loadFromFile(const std::string& path); // .tex container next to the image first, PNG otherwise
+	bool loadContainer(const std::string& path);
+	bool loadPNG(const std::string& path);
+	bool saveContainer(const std::string& path) const;
+	void generateMipmaps();
+
+	size_t levelOffset(unsigned int level) const;
+	size_t levelSize(unsigned int level) const;
+	unsigned int levelWidth(unsigned int level) const;
+	unsigned int levelHeight(unsigned int level) const;
+
+private:
+	struct ContainerHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t channels;
+		uint32_t levels;
+	};
+
+	static const uint32_t CONTAINER_VERSION = 1;
+};
@@ -19,6 +19,20 @@ void VAO::addBuffer(const GLuint& vbo_id) {
 	glVertexAttribPointer(attribIndex++, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 }
 
+void VAO::addIntegerInstanceBuffer(const GLuint& vbo_id, const GLint components, const GLenum type, const GLsizei stride, const size_t offset) {
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_id);
+	glEnableVertexAttribArray(attribIndex);
+	glVertexAttribIPointer(attribIndex, components, type, stride, reinterpret_cast<const void*>(offset));
+	glVertexAttribDivisor(attribIndex++, 1);
+}
+
+void VAO::addInstanceBuffer(const GLuint& vbo_id, const GLint components, const GLsizei stride, const size_t offset) {
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_id);
+	glEnableVertexAttribArray(attribIndex);
+	glVertexAttribPointer(attribIndex, components, GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
+	glVertexAttribDivisor(attribIndex++, 1);
+}
+
 void VAO::bind(const GLuint& id) {
 	glBindVertexArray(id);
 }
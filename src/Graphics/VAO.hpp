@@ -14,6 +14,8 @@ public:
 
 	GLuint getID() const;
 	void addBuffer(const GLuint& vbo_id);
+	void addIntegerInstanceBuffer(const GLuint& vbo_id, const GLint components, const GLenum type, const GLsizei stride = 0, const size_t offset = 0); // one value per instance
+	void addInstanceBuffer(const GLuint& vbo_id, const GLint components, const GLsizei stride = 0, const size_t offset = 0); // floats, one value per instance
 	static void bind(const GLuint& id);
 	static void unbind();
 
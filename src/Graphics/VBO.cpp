@@ -11,6 +11,18 @@ VBO::VBO(const std::array<GLfloat, 8>& userCoords) {
 	glBufferData(GL_ARRAY_BUFFER, sizeof(coords), &coords, GL_STATIC_DRAW);
 }
 
+VBO::VBO(const void* data, const GLsizeiptr size, const GLenum usage) {
+	glGenBuffers(1, &m_ID);
+	bind(m_ID);
+	glBufferData(GL_ARRAY_BUFFER, size, data, usage);
+}
+
+VBO::VBO(const GLsizeiptr size, const GLbitfield storageFlags) {
+	glGenBuffers(1, &m_ID);
+	bind(m_ID);
+	GLExtensions::bufferStorage(GL_ARRAY_BUFFER, size, nullptr, storageFlags);
+}
+
 VBO::~VBO() {
 	glDeleteBuffers(1, &m_ID);
 }
@@ -19,6 +31,21 @@ GLuint VBO::getID() const {
 	return m_ID;
 }
 
+void VBO::update(const GLintptr offset, const void* data, const GLsizeiptr size) {
+	bind(m_ID);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+}
+
+void VBO::orphan(const GLsizeiptr size, const GLenum usage) {
+	bind(m_ID);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
+}
+
+void* VBO::map(const GLintptr offset, const GLsizeiptr length, const GLbitfield access) {
+	bind(m_ID);
+	return glMapBufferRange(GL_ARRAY_BUFFER, offset, length, access);
+}
+
 void VBO::bind(const GLuint& id) {
 	glBindBuffer(GL_ARRAY_BUFFER, id);
 }
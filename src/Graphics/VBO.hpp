@@ -1,17 +1,23 @@
 #pragma once
 
 #include "glad/glad.h"
+#include "GLExtensions.hpp"
 #include <array>
 
 class VBO {
 public:
 	VBO(const std::array<GLfloat, 8>& userCoords);
+	VBO(const void* data, const GLsizeiptr size, const GLenum usage = GL_DYNAMIC_DRAW);
+	VBO(const GLsizeiptr size, const GLbitfield storageFlags); // immutable storage, needs GLExtensions::hasBufferStorage()
 	~VBO();
 
 	VBO(const VBO&) = delete;
 	VBO& operator=(const VBO&) = delete;
 
 	GLuint getID() const;
+	void update(const GLintptr offset, const void* data, const GLsizeiptr size);
+	void orphan(const GLsizeiptr size, const GLenum usage = GL_STREAM_DRAW); // fresh storage, the driver keeps the old one for pending draws
+	void* map(const GLintptr offset, const GLsizeiptr length, const GLbitfield access);
 	static void bind(const GLuint& id);
 	static void unbind();
 
@@ -0,0 +1,212 @@
+#include "ResourceManager.hpp"
+#include "../Utilities/FileSystem.hpp"
+#include "../Utilities/Hash.hpp"
+
+std::thread ResourceManager::m_worker;
+std::mutex ResourceManager::m_mutex;
+std::condition_variable ResourceManager::m_condition;
+std::deque<ResourceManager::Job> ResourceManager::m_pendingJobs;
+std::deque<ResourceManager::Job> ResourceManager::m_finishedJobs;
+bool ResourceManager::m_stopWorker = false;
+size_t ResourceManager::m_jobsInFlight = 0;
+
+std::vector<ResourceManager::Entry<Texture>> ResourceManager::m_textures;
+std::vector<ResourceManager::Entry<ShaderProgram>> ResourceManager::m_shaderPrograms;
+std::unordered_map<std::string, uint32_t> ResourceManager::m_handlesByPath;
+std::unordered_map<uint64_t, TextureHandle> ResourceManager::m_texturesByContent;
+std::unordered_map<uint64_t, ShaderProgramHandle> ResourceManager::m_shaderProgramsByContent;
+
+TextureHandle ResourceManager::loadTexture(const std::string& path) {
+	std::string key = "texture:" + FileSystem::normalizePath(path);
+	auto it = m_handlesByPath.find(key);
+	if (it != m_handlesByPath.end()) return it->second;
+
+	m_textures.emplace_back();
+	TextureHandle handle = static_cast<TextureHandle>(m_textures.size());
+	m_handlesByPath[key] = handle;
+
+	Job job;
+	job.type = EResourceType::TEXTURE;
+	job.handle = handle;
+	job.paths[0] = path;
+	request(std::move(job));
+	return handle;
+}
+
+ShaderProgramHandle ResourceManager::loadShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath) {
+	std::string key = "shader:" + FileSystem::normalizePath(vertexShaderPath) + "|" + FileSystem::normalizePath(fragmentShaderPath);
+	auto it = m_handlesByPath.find(key);
+	if (it != m_handlesByPath.end()) return it->second;
+
+	m_shaderPrograms.emplace_back();
+	ShaderProgramHandle handle = static_cast<ShaderProgramHandle>(m_shaderPrograms.size());
+	m_handlesByPath[key] = handle;
+
+	Job job;
+	job.type = EResourceType::SHADER_PROGRAM;
+	job.handle = handle;
+	job.paths[0] = vertexShaderPath;
+	job.paths[1] = fragmentShaderPath;
+	request(std::move(job));
+	return handle;
+}
+
+TextureHandle ResourceManager::createTexture(unsigned int width, unsigned int height) {
+	m_textures.emplace_back();
+	m_textures.back().resource.reset(new Texture(width, height));
+	m_textures.back().bytes = static_cast<size_t>(width) * height * 4;
+	return static_cast<TextureHandle>(m_textures.size());
+}
+
+TextureHandle ResourceManager::createTexture(const TextureImage& image, GLenum filter) {
+	m_textures.emplace_back();
+	m_textures.back().resource.reset(new Texture(image, filter));
+	m_textures.back().bytes = image.pixels.size();
+	return static_cast<TextureHandle>(m_textures.size());
+}
+
+void ResourceManager::resizeTexture(TextureHandle handle, unsigned int width, unsigned int height) {
+	Texture* texture = getTexture(handle);
+	if (!texture) return;
+
+	texture->resize(width, height);
+	m_textures[handle - 1].bytes = static_cast<size_t>(width) * height * 4;
+}
+
+bool ResourceManager::update() {
+	std::deque<Job> finished;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		finished.swap(m_finishedJobs);
+	}
+
+	for (Job& job : finished) {
+		upload(job);
+		m_jobsInFlight--;
+	}
+	return isLoaded();
+}
+
+bool ResourceManager::isLoaded() {
+	return m_jobsInFlight == 0;
+}
+
+Texture* ResourceManager::getTexture(TextureHandle handle) {
+	if (handle == INVALID_HANDLE || handle > m_textures.size()) return nullptr;
+	const Entry<Texture>& entry = m_textures[handle - 1];
+	if (entry.aliasOf != INVALID_HANDLE) return m_textures[entry.aliasOf - 1].resource.get();
+	return entry.resource.get();
+}
+
+ShaderProgram* ResourceManager::getShaderProgram(ShaderProgramHandle handle) {
+	if (handle == INVALID_HANDLE || handle > m_shaderPrograms.size()) return nullptr;
+	const Entry<ShaderProgram>& entry = m_shaderPrograms[handle - 1];
+	if (entry.aliasOf != INVALID_HANDLE) return m_shaderPrograms[entry.aliasOf - 1].resource.get();
+	return entry.resource.get();
+}
+
+ResourceManager::MemoryStats ResourceManager::getMemoryStats() {
+	MemoryStats stats;
+	for (const Entry<Texture>& entry : m_textures) {
+		if (!entry.resource) continue;
+		stats.textureCount++;
+		stats.textureBytes += entry.bytes;
+	}
+	for (const Entry<ShaderProgram>& entry : m_shaderPrograms) {
+		if (!entry.resource) continue;
+		stats.shaderProgramCount++;
+		stats.shaderProgramBytes += entry.bytes;
+	}
+	return stats;
+}
+
+void ResourceManager::unloadAll() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopWorker = true;
+		m_pendingJobs.clear();
+		m_finishedJobs.clear();
+	}
+	m_condition.notify_one();
+	if (m_worker.joinable()) m_worker.join();
+
+	m_stopWorker = false;
+	m_jobsInFlight = 0;
+
+	while (!m_shaderPrograms.empty()) m_shaderPrograms.pop_back(); // newest first
+	while (!m_textures.empty()) m_textures.pop_back();
+	m_handlesByPath.clear();
+	m_texturesByContent.clear();
+	m_shaderProgramsByContent.clear();
+}
+
+void ResourceManager::request(Job&& job) {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pendingJobs.push_back(std::move(job));
+	}
+	m_jobsInFlight++;
+
+	if (!m_worker.joinable()) m_worker = std::thread(workerLoop);
+	m_condition.notify_one();
+}
+
+void ResourceManager::workerLoop() {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_condition.wait(lock, [] { return m_stopWorker || !m_pendingJobs.empty(); });
+		if (m_stopWorker) return;
+
+		Job job = std::move(m_pendingJobs.front());
+		m_pendingJobs.pop_front();
+		lock.unlock();
+
+		switch (job.type) {
+		case EResourceType::TEXTURE:
+			job.success = job.image.loadFromFile(job.paths[0]);
+			job.contentHash = Hash::fnv1aBytes(job.image.pixels.data(), job.image.pixels.size());
+			job.contentHash = Hash::fnv1aBytes(&job.image.width, sizeof(job.image.width), job.contentHash);
+			job.contentHash = Hash::fnv1aBytes(&job.image.channels, sizeof(job.image.channels), job.contentHash);
+			break;
+		case EResourceType::SHADER_PROGRAM:
+			job.sources = ShaderProgram::loadSources(job.paths[0], job.paths[1]);
+			job.success = !job.sources.vertex.empty() && !job.sources.fragment.empty();
+			job.contentHash = Hash::fnv1a(job.sources.fragment, Hash::fnv1a(job.sources.vertex));
+			break;
+		}
+
+		lock.lock();
+		m_finishedJobs.push_back(std::move(job));
+	}
+}
+
+void ResourceManager::upload(Job& job) {
+	switch (job.type) {
+	case EResourceType::TEXTURE: {
+		if (!job.success) std::cerr << "Can't load texture: " << job.paths[0] << std::endl;
+
+		Entry<Texture>& entry = m_textures[job.handle - 1];
+		auto it = m_texturesByContent.find(job.contentHash);
+		if (job.success && it != m_texturesByContent.end()) {
+			entry.aliasOf = it->second;
+			break;
+		}
+		entry.resource.reset(new Texture(job.image));
+		entry.bytes = job.image.pixels.size();
+		if (job.success) m_texturesByContent[job.contentHash] = job.handle;
+		break;
+	}
+	case EResourceType::SHADER_PROGRAM: {
+		Entry<ShaderProgram>& entry = m_shaderPrograms[job.handle - 1];
+		auto it = m_shaderProgramsByContent.find(job.contentHash);
+		if (job.success && it != m_shaderProgramsByContent.end()) {
+			entry.aliasOf = it->second;
+			break;
+		}
+		entry.resource.reset(new ShaderProgram(job.sources));
+		entry.bytes = entry.resource->getBinarySize();
+		if (job.success) m_shaderProgramsByContent[job.contentHash] = job.handle;
+		break;
+	}
+	}
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../Graphics/Texture.hpp"
+#include "../Graphics/ShaderProgram.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t TextureHandle;
+typedef uint32_t ShaderProgramHandle;
+
+// Files are read and decoded on a worker thread; the finished CPU-side data is
+// queued back and turned into GL objects by update() on the GL thread.
+// Resources are addressed by handles and deduplicated by normalized path and by content,
+// so a file requested twice, or two files with equal contents, are uploaded once.
+class ResourceManager {
+public:
+	static const uint32_t INVALID_HANDLE = 0;
+
+	struct MemoryStats {
+		size_t textureCount = 0;
+		size_t textureBytes = 0;
+		size_t shaderProgramCount = 0;
+		size_t shaderProgramBytes = 0;
+	};
+
+	static TextureHandle loadTexture(const std::string& path);
+	static ShaderProgramHandle loadShaderProgram(const std::string& vertexShaderPath, const std::string& fragmentShaderPath);
+	static TextureHandle createTexture(unsigned int width, unsigned int height); // GL thread only, available at once
+	static TextureHandle createTexture(const TextureImage& image, GLenum filter = GL_LINEAR); // generated pixels, GL thread only
+	static void resizeTexture(TextureHandle handle, unsigned int width, unsigned int height);
+
+	static bool update(); // uploads what the worker finished, true once nothing is pending
+	static bool isLoaded();
+
+	static Texture* getTexture(TextureHandle handle); // nullptr until uploaded
+	static ShaderProgram* getShaderProgram(ShaderProgramHandle handle);
+
+	static MemoryStats getMemoryStats();
+	static void unloadAll(); // stops the worker and frees GL objects, call before the GL context is destroyed
+
+private:
+	ResourceManager() = delete;
+
+	enum class EResourceType { TEXTURE, SHADER_PROGRAM };
+
+	struct Job {
+		EResourceType type;
+		uint32_t handle;
+		std::string paths[2];
+
+		TextureImage image;
+		ShaderProgram::Sources sources;
+		uint64_t contentHash = 0;
+		bool success = false;
+	};
+
+	template <class T>
+	struct Entry {
+		std::unique_ptr<T> resource;
+		uint32_t aliasOf = INVALID_HANDLE; // same contents as an earlier entry
+		size_t bytes = 0;
+	};
+
+	static void request(Job&& job);
+	static void workerLoop();
+	static void upload(Job& job);
+
+	static std::thread m_worker;
+	static std::mutex m_mutex;
+	static std::condition_variable m_condition;
+	static std::deque<Job> m_pendingJobs;
+	static std::deque<Job> m_finishedJobs;
+	static bool m_stopWorker;
+	static size_t m_jobsInFlight;
+
+	static std::vector<Entry<Texture>> m_textures; // index is handle - 1
+	static std::vector<Entry<ShaderProgram>> m_shaderPrograms;
+	static std::unordered_map<std::string, uint32_t> m_handlesByPath;
+	static std::unordered_map<uint64_t, TextureHandle> m_texturesByContent;
+	static std::unordered_map<uint64_t, ShaderProgramHandle> m_shaderProgramsByContent;
+};
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../AI/ExpectimaxSearch.hpp"
+#include "../AI/Heuristic.hpp"
+#include "../AI/MonteCarloPolicy.hpp"
+#include "../AI/NTupleWeightFile.hpp"
+#include "../AI/TranspositionTable.hpp"
+#include "../Game/HeadlessGame.hpp"
+
+// Plays seeded headless games with the AI on all cores and reports scores, tile rates
+// and search statistics. Game i uses seed + i, so runs are reproducible per game.
+// Usage: simulate [--games N] [--threads N] [--budget MS] [--depth N] [--seed N] [--table MB] [--weights name=value,...]
+//                 [--policy expectimax|montecarlo|ntuple] [--rollouts K] [--greedy] [--mc-threads N] [--ntuple PATH]
+// The Monte Carlo policy plays K rollouts per legal move on --mc-threads threads per game.
+// The n-tuple policy moves greedily by a mapped NTupleWeightFile, shared by all threads.
+static const char* USAGE = " [--games N] [--threads N] [--budget MS] [--depth N] [--seed N] [--table MB] [--weights name=value,...]"
+    " [--policy expectimax|montecarlo|ntuple] [--rollouts K] [--greedy] [--mc-threads N] [--ntuple PATH]";
+
+enum class EPolicy { EXPECTIMAX, MONTE_CARLO, N_TUPLE };
+
+struct Totals {
+    uint64_t games = 0;
+    uint64_t score = 0;
+    uint64_t bestScore = 0;
+    uint64_t moves = 0;
+    uint64_t nodes = 0;
+    uint64_t depth = 0; // summed over moves
+    double searchMilliseconds = 0.0;
+    uint64_t rollouts = 0;
+    uint64_t rolloutMoves = 0;
+    uint64_t reached[16] = {}; // games whose largest tile was at least 2^k
+};
+
+int main(int argc, char** argv) {
+    int games = 100;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    double budget = 5.0;
+    int depth = ExpectimaxSearch::MAX_DEPTH;
+    uint32_t seed = 1;
+    size_t tableMegabytes = 64;
+    Heuristic::Weights weights;
+    EPolicy policyType = EPolicy::EXPECTIMAX;
+    std::string nTuplePath = "ntuple.weights";
+    int rollouts = 100;
+    MonteCarloPolicy::ERollout rollout = MonteCarloPolicy::ERollout::RANDOM;
+    unsigned int rolloutThreads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) games = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--budget") == 0 && i + 1 < argc) budget = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) depth = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--table") == 0 && i + 1 < argc) tableMegabytes = static_cast<size_t>(std::atoll(argv[++i]));
+        else if (std::strcmp(argv[i], "--weights") == 0 && i + 1 < argc) {
+            if (!weights.parse(argv[++i])) {
+                std::cerr << "Can't parse weights: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc && std::strcmp(argv[i + 1], "expectimax") == 0) policyType = EPolicy::EXPECTIMAX, i++;
+        else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc && std::strcmp(argv[i + 1], "montecarlo") == 0) policyType = EPolicy::MONTE_CARLO, i++;
+        else if (std::strcmp(argv[i], "--policy") == 0 && i + 1 < argc && std::strcmp(argv[i + 1], "ntuple") == 0) policyType = EPolicy::N_TUPLE, i++;
+        else if (std::strcmp(argv[i], "--ntuple") == 0 && i + 1 < argc) nTuplePath = argv[++i];
+        else if (std::strcmp(argv[i], "--rollouts") == 0 && i + 1 < argc) rollouts = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--greedy") == 0) rollout = MonteCarloPolicy::ERollout::GREEDY;
+        else if (std::strcmp(argv[i], "--mc-threads") == 0 && i + 1 < argc) rolloutThreads = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "Usage: " << argv[0] << USAGE << std::endl;
+            return -1;
+        }
+    }
+
+    const Heuristic heuristic(weights);
+    NTupleWeightFile nTuples;
+    if (policyType == EPolicy::N_TUPLE) {
+        if (!nTuples.open(nTuplePath)) {
+            std::cerr << "Can't map n-tuple weights: " << nTuplePath << std::endl;
+            return -1;
+        }
+        std::cout << "N-tuple weights: " << NTupleWeightFile::getPrecisionName(nTuples.getPrecision()) << ", "
+            << nTuples.getFileSize() / (1024 * 1024) << " MB" << std::endl;
+    }
+    std::atomic<int> nextGame(0);
+    Totals totals;
+    std::mutex totalsMutex;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            std::unique_ptr<TranspositionTable> table;
+            std::unique_ptr<ExpectimaxSearch> search;
+            std::unique_ptr<MonteCarloPolicy> policy;
+            if (policyType == EPolicy::MONTE_CARLO) {
+                policy.reset(new MonteCarloPolicy(rollouts, rolloutThreads, rollout, (static_cast<uint64_t>(seed) << 32) | t));
+            }
+            else if (policyType == EPolicy::EXPECTIMAX) {
+                table.reset(new TranspositionTable(std::max<size_t>(tableMegabytes / threads, 1))); // one each, a table ages per search
+                search.reset(new ExpectimaxSearch(heuristic, *table));
+            }
+
+            for (int index = nextGame++; index < games; index = nextGame++) {
+                HeadlessGame game(seed + static_cast<uint32_t>(index));
+                Totals result;
+                while (!game.isOver()) {
+                    if (policy) {
+                        MonteCarloPolicy::Result move = policy->chooseMove(game.getBoard());
+                        game.play(static_cast<Bitboard::EDirection>(move.move));
+                        result.rollouts += move.rollouts;
+                        result.searchMilliseconds += move.milliseconds;
+                        continue;
+                    }
+                    if (policyType == EPolicy::N_TUPLE) {
+                        std::chrono::steady_clock::time_point moveStart = std::chrono::steady_clock::now();
+                        game.play(static_cast<Bitboard::EDirection>(nTuples.chooseMove(game.getBoard())));
+                        result.searchMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - moveStart).count();
+                        continue;
+                    }
+                    ExpectimaxSearch::Result move = search->search(game.getBoard(), budget, depth);
+                    game.play(static_cast<Bitboard::EDirection>(move.move));
+                    result.nodes += move.nodes;
+                    result.depth += move.depth;
+                    result.searchMilliseconds += move.milliseconds;
+                }
+
+                std::lock_guard<std::mutex> lock(totalsMutex);
+                totals.games++;
+                totals.score += game.getScore();
+                totals.bestScore = std::max(totals.bestScore, game.getScore());
+                totals.moves += game.getMoves();
+                totals.nodes += result.nodes;
+                totals.depth += result.depth;
+                totals.searchMilliseconds += result.searchMilliseconds;
+                totals.rollouts += result.rollouts;
+                for (int k = 0; k <= game.getMaxExponent(); k++) totals.reached[k]++;
+            }
+
+            if (policy) {
+                std::lock_guard<std::mutex> lock(totalsMutex);
+                totals.rolloutMoves += policy->getStats().rolloutMoves;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (totals.games == 0) return 0;
+
+    double moves = static_cast<double>(std::max<uint64_t>(totals.moves, 1));
+    std::cout << std::fixed << std::setprecision(2)
+        << "Games: " << totals.games << " in " << seconds << " s, " << totals.moves / seconds << " moves/s" << std::endl
+        << "Score: average " << static_cast<double>(totals.score) / totals.games << ", best " << totals.bestScore << std::endl;
+    if (policyType == EPolicy::MONTE_CARLO) {
+        double rolloutSeconds = totals.searchMilliseconds / 1000.0 + 1e-9;
+        std::cout << "Rollouts: " << totals.searchMilliseconds / moves << " ms/move, " << totals.rollouts / moves << " rollouts/move, "
+            << totals.rollouts / rolloutSeconds << " rollouts/s, " << totals.rolloutMoves / rolloutSeconds << " playout moves/s" << std::endl;
+    }
+    else if (policyType == EPolicy::N_TUPLE) {
+        std::cout << "N-tuple: " << totals.searchMilliseconds * 1000.0 / moves << " us/move" << std::endl;
+    }
+    else std::cout << "Search: " << totals.searchMilliseconds / moves << " ms/move, depth " << totals.depth / moves
+        << ", " << totals.nodes / moves << " nodes/move, " << totals.nodes / (totals.searchMilliseconds / 1000.0 + 1e-9) << " nodes/s" << std::endl;
+    for (int k = 11; k < 16; k++) {
+        if (totals.reached[k]) std::cout << (1 << k) << ": " << 100.0 * totals.reached[k] / totals.games << "%" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../AI/RetrogradeSolver.hpp"
+#include "../AI/SolutionTable.hpp"
+
+// Solves a small board exactly and writes the table of win probabilities, or with --query
+// reads one back. --external keeps the layers and spilled sort runs in a directory instead
+// of memory, for boards whose state space does not fit.
+// Usage: solve [--width W] [--height H] [--target K] [--threads N] [--output PATH] [--external DIR] [--memory MB] [--query PATH]
+static const char* USAGE = " [--width W] [--height H] [--target K] [--threads N] [--output PATH] [--external DIR] [--memory MB] [--query PATH]";
+static const uint32_t PROGRESS_TILE_SUM = 256; // a line whenever the tile sum passes a multiple of it
+
+static void printTable(const SolutionTable& table) {
+    std::cout << std::fixed << std::setprecision(4)
+        << "Table: " << table.getWidth() << "x" << table.getHeight() << ", target " << (1 << table.getTarget())
+        << ", " << table.getStateCount() << " states" << std::endl
+        << "Win probability from the start: " << 100.0 * table.getStartValue() << "%" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    RetrogradeSolver::Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string output = "solution.table";
+    std::string query;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc) options.width = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) options.height = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--target") == 0 && i + 1 < argc) options.target = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) options.threads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+        else if (std::strcmp(argv[i], "--external") == 0 && i + 1 < argc) options.workDirectory = argv[++i];
+        else if (std::strcmp(argv[i], "--memory") == 0 && i + 1 < argc) options.memoryMegabytes = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (std::strcmp(argv[i], "--query") == 0 && i + 1 < argc) query = argv[++i];
+        else {
+            std::cerr << "Usage: " << argv[0] << USAGE << std::endl;
+            return -1;
+        }
+    }
+
+    if (!query.empty()) {
+        SolutionTable table;
+        if (!table.open(query)) {
+            std::cerr << "Can't read the table: " << query << std::endl;
+            return -1;
+        }
+        printTable(table);
+        return 0;
+    }
+
+    if (options.width < 2 || options.width > 4 || options.height < 2 || options.height > 4 || options.target < 2 || options.target > 15) {
+        std::cerr << "The board must be 2 to 4 cells a side, the target exponent 2 to 15" << std::endl;
+        return -1;
+    }
+
+    RetrogradeSolver solver(options);
+    uint32_t lastProgress = 0;
+    bool solved = solver.solve(output, [&](const char* phase, uint32_t tileSum, uint64_t states) {
+        uint32_t progress = tileSum / PROGRESS_TILE_SUM;
+        if (progress == lastProgress) return;
+        lastProgress = progress;
+        std::cout << phase << ": tile sum " << tileSum << ", " << states << " states" << std::endl;
+    });
+    if (!solved) {
+        std::cerr << "Can't write " << output << (options.workDirectory.empty() ? "" : " or the layers in " + options.workDirectory) << std::endl;
+        return -1;
+    }
+
+    const RetrogradeSolver::Stats& stats = solver.getStats();
+    double seconds = stats.forwardSeconds + stats.backwardSeconds;
+    std::cout << std::fixed << std::setprecision(2)
+        << "States: " << stats.states << " in " << stats.layers << " layers, largest " << stats.largestLayer << ", spilled runs " << stats.spilledRuns << std::endl
+        << "Forward " << stats.forwardSeconds << " s, backward " << stats.backwardSeconds << " s, " << stats.states / std::max(seconds, 1e-9) << " states/s" << std::endl;
+
+    SolutionTable table;
+    if (table.open(output)) printTable(table);
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include <iostream>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+
+#include "../Graphics/TextureImage.hpp"
+
+// Converts a PNG into the .tex container loaded by Texture: pixels are already
+// flipped for OpenGL and the mip chain is optional.
+// Usage: texconv <input.png> <output.tex> [--mipmaps]
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.png> <output.tex> [--mipmaps]" << std::endl;
+        return -1;
+    }
+
+    bool mipmaps = argc > 3 && std::string(argv[3]) == "--mipmaps";
+
+    TextureImage image;
+    if (!image.loadPNG(argv[1])) {
+        std::cerr << "Can't load image: " << argv[1] << std::endl;
+        return -1;
+    }
+
+    if (mipmaps) image.generateMipmaps();
+
+    if (!image.saveContainer(argv[2])) {
+        std::cerr << "Can't write container: " << argv[2] << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../AI/NTupleNetwork.hpp"
+#include "../AI/NTupleWeightFile.hpp"
+#include "../Game/HeadlessGame.hpp"
+
+// Trains an n-tuple network by TD(0) on afterstates (the board right after a move, before
+// the spawn) with self-play on all cores. Every move is the greedy one by reward plus
+// afterstate value, and the previous afterstate's value is pulled toward that. Threads
+// share the weights without locks. Each report covers the games finished since the last
+// one, and the weights are checkpointed at every report. --export then writes a copy at
+// another precision and plays --compare games with both files to show what it costs.
+// Usage: train [--games N] [--threads N] [--alpha A] [--seed N] [--report N] [--output PATH] [--resume PATH]
+//              [--export PATH] [--precision float32|float16|int16] [--compare N]
+static const char* USAGE = " [--games N] [--threads N] [--alpha A] [--seed N] [--report N] [--output PATH] [--resume PATH]"
+    " [--export PATH] [--precision float32|float16|int16] [--compare N]";
+static const size_t BENCHMARK_BOARDS = 1 << 20;
+
+struct Interval {
+    uint64_t games = 0;
+    uint64_t score = 0;
+    uint64_t moves = 0;
+    uint64_t reached[16] = {}; // games whose largest tile was at least 2^k
+};
+
+static uint64_t playTrainingGame(NTupleNetwork& network, float alpha, uint32_t seed, int& maxExponent, uint64_t& moves) {
+    std::mt19937 random(seed);
+    Bitboard::Board board = Bitboard::spawnTile(Bitboard::spawnTile(0, static_cast<uint32_t>(random())), static_cast<uint32_t>(random()));
+    Bitboard::Board previous = 0; // afterstate of the last move
+    bool hasPrevious = false;
+    uint64_t score = 0;
+    moves = 0;
+
+    for (;;) {
+        Bitboard::Board bestAfterstate = board;
+        float bestValue = 0.f;
+        uint64_t bestReward = 0;
+        for (int direction = 0; direction < 4; direction++) {
+            Bitboard::Merges merges;
+            Bitboard::Board afterstate = Bitboard::move(board, static_cast<Bitboard::EDirection>(direction), merges);
+            if (afterstate == board) continue;
+
+            uint64_t reward = merges.score;
+            float value = static_cast<float>(reward) + network.evaluate(afterstate);
+            if (bestAfterstate == board || value > bestValue) {
+                bestAfterstate = afterstate;
+                bestValue = value;
+                bestReward = reward;
+            }
+        }
+        if (bestAfterstate == board) break;
+
+        if (hasPrevious) network.adjust(previous, alpha * (bestValue - network.evaluate(previous)));
+        previous = bestAfterstate;
+        hasPrevious = true;
+        score += bestReward;
+        moves++;
+        board = Bitboard::spawnTile(bestAfterstate, static_cast<uint32_t>(random()));
+    }
+    if (hasPrevious) network.adjust(previous, -alpha * network.evaluate(previous)); // nothing follows the last afterstate
+
+    maxExponent = Bitboard::maxExponent(board);
+    return score;
+}
+
+struct Comparison {
+    uint64_t games = 0;
+    uint64_t score = 0;
+    uint64_t reached[16] = {};
+    uint64_t positions = 0; // of the quantized games
+    uint64_t agreements = 0; // positions where both files pick the same move
+};
+
+// plays the same seeded games with each file, on all threads
+static void playComparisonGames(const NTupleWeightFile& baseline, const NTupleWeightFile& quantized, int games, uint32_t seed, unsigned int threads,
+    Comparison results[2], std::vector<Bitboard::Board>& boards) {
+    std::atomic<int> nextGame(0);
+    std::mutex resultsMutex;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (int index = nextGame++; index < games; index = nextGame++) {
+                for (int which = 0; which < 2; which++) {
+                    const NTupleWeightFile& player = which == 0 ? baseline : quantized;
+                    HeadlessGame game(seed + static_cast<uint32_t>(index));
+                    Comparison result;
+                    std::vector<Bitboard::Board> seen;
+                    while (!game.isOver()) {
+                        int move = player.chooseMove(game.getBoard());
+                        if (which == 1) {
+                            result.positions++;
+                            if (baseline.chooseMove(game.getBoard()) == move) result.agreements++;
+                        }
+                        else seen.push_back(game.getBoard());
+                        game.play(static_cast<Bitboard::EDirection>(move));
+                    }
+
+                    std::lock_guard<std::mutex> lock(resultsMutex);
+                    Comparison& total = results[which];
+                    total.games++;
+                    total.score += game.getScore();
+                    for (int k = 0; k <= game.getMaxExponent(); k++) total.reached[k]++;
+                    total.positions += result.positions;
+                    total.agreements += result.agreements;
+                    for (size_t i = 0; i < seen.size() && boards.size() < BENCHMARK_BOARDS; i++) boards.push_back(seen[i]);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+static double measureEvaluations(const NTupleWeightFile& file, const std::vector<Bitboard::Board>& boards) { // per second, one thread
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    float sum = 0.f;
+    for (Bitboard::Board board : boards) sum += file.evaluate(board);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    volatile float sink = sum; // keeps the loop
+    (void)sink;
+    return boards.size() / std::max(seconds, 1e-9);
+}
+
+static bool exportAndCompare(const NTupleNetwork& network, const std::string& baselinePath, const std::string& exportPath,
+    NTupleWeightFile::EPrecision precision, int games, uint32_t seed, unsigned int threads) {
+    if (!NTupleWeightFile::write(exportPath, network, precision)) {
+        std::cerr << "Can't write weights: " << exportPath << std::endl;
+        return false;
+    }
+    NTupleWeightFile files[2];
+    if (!files[0].open(baselinePath) || !files[1].open(exportPath)) {
+        std::cerr << "Can't map " << baselinePath << " or " << exportPath << std::endl;
+        return false;
+    }
+    if (games <= 0) return true;
+
+    Comparison results[2];
+    std::vector<Bitboard::Board> boards;
+    playComparisonGames(files[0], files[1], games, seed, threads, results, boards);
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (int which = 0; which < 2; which++) {
+        measureEvaluations(files[which], boards); // first touch of the pages
+        const Comparison& result = results[which];
+        std::cout << std::setw(8) << NTupleWeightFile::getPrecisionName(files[which].getPrecision()) << ": "
+            << files[which].getFileSize() / (1024.0 * 1024.0) << " MB, " << measureEvaluations(files[which], boards) / 1e6 << "M evaluations/s"
+            << ", average " << static_cast<double>(result.score) / result.games
+            << ", 2048 " << 100.0 * result.reached[11] / result.games << "%"
+            << ", 4096 " << 100.0 * result.reached[12] / result.games << "%"
+            << ", 8192 " << 100.0 * result.reached[13] / result.games << "%" << std::endl;
+    }
+    std::cout << "Same move as float32: " << 100.0 * results[1].agreements / std::max<uint64_t>(results[1].positions, 1) << "% of positions" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint64_t games = 1000000;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    float alpha = 0.1f;
+    uint32_t seed = 1;
+    uint64_t reportInterval = 1000000;
+    std::string output = "ntuple.weights";
+    std::string resume;
+    std::string exportPath;
+    NTupleWeightFile::EPrecision precision = NTupleWeightFile::EPrecision::INT16;
+    int compareGames = 1000;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc) games = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--alpha") == 0 && i + 1 < argc) alpha = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--report") == 0 && i + 1 < argc) reportInterval = std::max<uint64_t>(1, std::strtoull(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+        else if (std::strcmp(argv[i], "--resume") == 0 && i + 1 < argc) resume = argv[++i];
+        else if (std::strcmp(argv[i], "--export") == 0 && i + 1 < argc) exportPath = argv[++i];
+        else if (std::strcmp(argv[i], "--precision") == 0 && i + 1 < argc && NTupleWeightFile::parsePrecision(argv[i + 1], precision)) i++;
+        else if (std::strcmp(argv[i], "--compare") == 0 && i + 1 < argc) compareGames = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << USAGE << std::endl;
+            return -1;
+        }
+    }
+
+    NTupleNetwork network;
+    if (!resume.empty() && !network.load(resume)) {
+        std::cerr << "Can't load weights: " << resume << std::endl;
+        return -1;
+    }
+    std::cout << "Network: " << network.getTuples().size() << " tuples, " << network.getFeatureCount() << " features, "
+        << network.getWeightCount() * sizeof(float) / (1024 * 1024) << " MB" << std::endl;
+
+    std::atomic<uint64_t> nextGame(0);
+    uint64_t finished = 0;
+    Interval interval;
+    std::mutex intervalMutex;
+    std::mutex saveMutex;
+    std::chrono::steady_clock::time_point intervalStart = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            for (uint64_t index = nextGame++; index < games; index = nextGame++) {
+                int maxExponent = 0;
+                uint64_t moves = 0;
+                uint64_t score = playTrainingGame(network, alpha, seed + static_cast<uint32_t>(index), maxExponent, moves);
+
+                std::unique_lock<std::mutex> lock(intervalMutex);
+                interval.games++;
+                interval.score += score;
+                interval.moves += moves;
+                for (int k = 0; k <= maxExponent; k++) interval.reached[k]++;
+                if (++finished % reportInterval != 0 && finished != games) continue;
+
+                double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - intervalStart).count();
+                std::cout << std::fixed << std::setprecision(2)
+                    << "Games " << finished << ": average " << static_cast<double>(interval.score) / interval.games
+                    << ", 2048 " << 100.0 * interval.reached[11] / interval.games << "%"
+                    << ", 4096 " << 100.0 * interval.reached[12] / interval.games << "%"
+                    << ", 8192 " << 100.0 * interval.reached[13] / interval.games << "%"
+                    << ", " << interval.games / seconds << " games/s, " << interval.moves / seconds << " moves/s" << std::endl;
+                interval = Interval();
+                intervalStart = std::chrono::steady_clock::now();
+                lock.unlock();
+
+                // the other threads keep training while the checkpoint is written
+                std::lock_guard<std::mutex> saveLock(saveMutex);
+                if (!network.save(output)) std::cerr << "Can't write weights: " << output << std::endl;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    if (exportPath.empty()) return 0;
+    if (games == 0 && !network.save(output)) { // nothing trained, the float32 side of the comparison is still needed
+        std::cerr << "Can't write weights: " << output << std::endl;
+        return -1;
+    }
+    return exportAndCompare(network, output, exportPath, precision, compareGames, seed, threads) ? 0 : -1;
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "../AI/Heuristic.hpp"
+#include "../AI/WeightTuner.hpp"
+
+// Tunes the heuristic weights with WeightTuner on all cores and saves a checkpoint after
+// every iteration; --resume continues from it. The result goes to simulate --weights.
+// Usage: tune [--iterations N] [--threads N] [--depth N] [--seed N] [--table MB] [--weights name=value,...] [--tune name,...]
+//             [--gradient-games N] [--batch N] [--max-games N] [--margin P] [--checkpoint PATH] [--resume]
+static const char* USAGE = " [--iterations N] [--threads N] [--depth N] [--seed N] [--table MB] [--weights name=value,...] [--tune name,...]"
+    " [--gradient-games N] [--batch N] [--max-games N] [--margin P] [--checkpoint PATH] [--resume]";
+
+static bool parseTuned(const std::string& text, std::vector<int>& tuned) { // "empty,merges"
+    tuned.clear();
+    std::stringstream stream(text);
+    std::string name;
+    while (std::getline(stream, name, ',')) {
+        int index = 0;
+        while (index < Heuristic::Weights::COUNT && name != Heuristic::Weights::getName(index)) index++;
+        if (index == Heuristic::Weights::COUNT) return false;
+        tuned.push_back(index);
+    }
+    return !tuned.empty();
+}
+
+int main(int argc, char** argv) {
+    WeightTuner::Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < Heuristic::Weights::COUNT; i++) options.tuned.push_back(i); // base only lifts live boards above lost ones
+    Heuristic::Weights weights;
+    int iterations = 100;
+    std::string checkpoint = "tuner.checkpoint";
+    bool resume = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) options.threads = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--depth") == 0 && i + 1 < argc) options.depth = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(argv[i], "--table") == 0 && i + 1 < argc) options.tableMegabytes = static_cast<size_t>(std::atoll(argv[++i]));
+        else if (std::strcmp(argv[i], "--gradient-games") == 0 && i + 1 < argc) options.gradientGames = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--batch") == 0 && i + 1 < argc) options.batchGames = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--max-games") == 0 && i + 1 < argc) options.maxGames = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "--margin") == 0 && i + 1 < argc) options.margin = static_cast<float>(std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) checkpoint = argv[++i];
+        else if (std::strcmp(argv[i], "--resume") == 0) resume = true;
+        else if (std::strcmp(argv[i], "--weights") == 0 && i + 1 < argc) {
+            if (!weights.parse(argv[++i])) {
+                std::cerr << "Can't parse weights: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else if (std::strcmp(argv[i], "--tune") == 0 && i + 1 < argc) {
+            if (!parseTuned(argv[++i], options.tuned)) {
+                std::cerr << "Can't parse weight names: " << argv[i] << std::endl;
+                return -1;
+            }
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << USAGE << std::endl;
+            return -1;
+        }
+    }
+    if (options.margin <= 0.f || options.margin >= 0.5f) {
+        std::cerr << "The margin must be between 0 and 0.5" << std::endl;
+        return -1;
+    }
+
+    WeightTuner tuner(options, weights);
+    if (resume) {
+        if (!tuner.loadCheckpoint(checkpoint)) {
+            std::cerr << "Can't read the checkpoint: " << checkpoint << std::endl;
+            return -1;
+        }
+        std::cout << "Resumed at iteration " << tuner.getIterationCount() << ": " << tuner.getWeights().toString() << std::endl;
+    }
+
+    for (int i = 0; i < iterations; i++) {
+        WeightTuner::Iteration iteration = tuner.runIteration();
+        std::cout << std::fixed << std::setprecision(2)
+            << "Iteration " << iteration.index << ": gradient " << 100.0 * iteration.gradient << "%, "
+            << (iteration.accepted ? "accepted" : "rejected") << " after " << iteration.games << " games"
+            << " (" << iteration.wins << " wins, " << iteration.losses << " losses, LLR " << iteration.logLikelihoodRatio << "), score "
+            << iteration.candidateScore << " against " << iteration.incumbentScore << ", " << iteration.seconds << " s, "
+            << iteration.moves / std::max(iteration.seconds, 1e-9) << " moves/s" << std::endl;
+        if (iteration.accepted) std::cout << "Weights: " << tuner.getWeights().toString() << std::endl;
+
+        if (!tuner.saveCheckpoint(checkpoint)) {
+            std::cerr << "Can't write the checkpoint: " << checkpoint << std::endl;
+            return -1;
+        }
+    }
+
+    std::cout << "Accepted " << tuner.getAcceptedCount() << " of " << tuner.getIterationCount() << " candidates" << std::endl
+        << "Weights: " << tuner.getWeights().toString() << std::endl;
+    return 0;
+}
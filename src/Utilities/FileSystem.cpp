@@ -0,0 +1,76 @@
+#include "FileSystem.hpp"
+
+#include <fstream>
+#include <cerrno>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+bool FileSystem::readFile(const std::string& path, std::vector<unsigned char>& data) {
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return false;
+
+	std::streamsize size = file.tellg();
+	if (size < 0) return false;
+	file.seekg(0, std::ios::beg);
+
+	data.resize(static_cast<size_t>(size));
+	return size == 0 || file.read(reinterpret_cast<char*>(data.data()), size).good();
+}
+
+bool FileSystem::writeFile(const std::string& path, const void* data, size_t size) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) return false;
+
+	file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+	return file.good();
+}
+
+bool FileSystem::createDirectories(const std::string& path) {
+	for (size_t pos = 0; pos != std::string::npos;) {
+		pos = path.find_first_of("/\\", pos + 1);
+		std::string directory = path.substr(0, pos);
+		if (directory.empty()) continue;
+#ifdef _WIN32
+		int result = _mkdir(directory.c_str());
+#else
+		int result = mkdir(directory.c_str(), 0755);
+#endif
+		if (result != 0 && errno != EEXIST) return false;
+	}
+	return true;
+}
+
+std::string FileSystem::normalizePath(const std::string& path) {
+	std::vector<std::string> parts;
+	bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+
+	size_t begin = 0;
+	while (begin <= path.size()) {
+		size_t end = path.find_first_of("/\\", begin);
+		if (end == std::string::npos) end = path.size();
+		std::string part = path.substr(begin, end - begin);
+		begin = end + 1;
+
+		if (part.empty() || part == ".") continue;
+		if (part == ".." && !parts.empty() && parts.back() != "..") parts.pop_back();
+		else parts.push_back(part);
+	}
+
+	std::string normalized = absolute ? "/" : "";
+	for (size_t i = 0; i < parts.size(); i++) {
+		if (i > 0) normalized += '/';
+		normalized += parts[i];
+	}
+	return normalized;
+}
+
+std::string FileSystem::replaceExtension(const std::string& path, const std::string& extension) {
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + extension;
+	return path.substr(0, dot) + extension;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+class FileSystem {
+public:
+	static bool readFile(const std::string& path, std::vector<unsigned char>& data);
+	static bool writeFile(const std::string& path, const void* data, size_t size);
+	static bool createDirectories(const std::string& path);
+	static std::string normalizePath(const std::string& path); // forward slashes, no "." or "dir/.." parts
+	static std::string replaceExtension(const std::string& path, const std::string& extension);
+};
@@ -0,0 +1,28 @@
+#include "Hash.hpp"
+
+uint64_t Hash::fnv1aBytes(const void* data, size_t size, uint64_t seed) {
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64_t Hash::fnv1a(const std::string& str, uint64_t seed) {
+	return fnv1aBytes(str.data(), str.size(), seed);
+}
+
+uint64_t Hash::mix64(uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+	return value ^ (value >> 31);
+}
+
+std::string Hash::toHex(uint64_t hash) {
+	static const char digits[] = "0123456789abcdef";
+	std::string hex(16, '0');
+	for (int i = 15; i >= 0; i--, hash >>= 4) hex[i] = digits[hash & 0xF];
+	return hex;
+}
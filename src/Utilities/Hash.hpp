@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+class Hash { // FNV-1a, 64 bit, plus a finalizer for keys that are already 64-bit values
+public:
+	static const uint64_t SEED = 14695981039346656037ull;
+
+	static uint64_t fnv1aBytes(const void* data, size_t size, uint64_t seed = SEED); // named apart so a C string can never bind to (data, size)
+	static uint64_t fnv1a(const std::string& str, uint64_t seed = SEED);
+	static uint64_t mix64(uint64_t value); // SplitMix64 finalizer, every input bit reaches every output bit
+	static std::string toHex(uint64_t hash);
+};
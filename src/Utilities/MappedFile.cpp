@@ -0,0 +1,72 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const std::string& path, bool readAhead) {
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping) return false;
+
+	m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping); // the view keeps the mapping alive
+	if (!m_data) return false;
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+	(void)readAhead; // Windows reads ahead on its own
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0) return false;
+	struct stat status;
+	void* memory = MAP_FAILED;
+	if (fstat(file, &status) == 0 && status.st_size > 0) {
+		memory = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+	}
+	::close(file); // the mapping keeps the file alive
+	if (memory == MAP_FAILED) return false;
+
+	m_data = memory;
+	m_size = static_cast<size_t>(status.st_size);
+	if (readAhead) madvise(memory, m_size, MADV_WILLNEED); // starts reading in the background, open() returns at once
+#endif
+	return true;
+}
+
+void MappedFile::close() {
+	if (!m_data) return;
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	munmap(const_cast<void*>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool MappedFile::isOpen() const {
+	return m_data != nullptr;
+}
+
+const void* MappedFile::getData() const {
+	return m_data;
+}
+
+size_t MappedFile::getSize() const {
+	return m_size;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+class MappedFile { // a whole file mapped read-only, the pages load on first touch
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path, bool readAhead = false); // false for a missing or empty file
+	void close();
+
+	bool isOpen() const;
+	const void* getData() const;
+	size_t getSize() const;
+
+private:
+	const void* m_data = nullptr;
+	size_t m_size = 0;
+};
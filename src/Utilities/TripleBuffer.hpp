@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Single producer, single consumer hand-off of the latest value. The producer fills
+// its private slot and swaps it with the shared one, the consumer swaps the shared
+// slot with its own when it holds something fresh. Neither side ever waits, and the
+// consumer always sees the newest complete value, intermediate ones are dropped.
+template <class T>
+class TripleBuffer {
+public:
+	TripleBuffer() : m_buffers(), m_shared(2), m_write(0), m_read(1) {}
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	T& writeBuffer() { // producer only
+		return m_buffers[m_write];
+	}
+
+	void publish() { // producer only
+		m_write = m_shared.exchange(m_write | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+	}
+
+	bool consume() { // consumer only, returns false when nothing new was published
+		if (!(m_shared.load(std::memory_order_relaxed) & FRESH_BIT)) return false;
+
+		m_read = m_shared.exchange(m_read, std::memory_order_acq_rel) & INDEX_MASK;
+		return true;
+	}
+
+	const T& readBuffer() const { // consumer only
+		return m_buffers[m_read];
+	}
+
+private:
+	static const uint8_t INDEX_MASK = 0x3;
+	static const uint8_t FRESH_BIT = 0x4;
+
+	T m_buffers[3];
+	std::atomic<uint8_t> m_shared; // slot index owned by neither side, plus FRESH_BIT
+	uint8_t m_write;
+	uint8_t m_read;
+};
@@ -4,8 +4,43 @@
 #define STBI_ONLY_PNG
 
 #include "Game/Game2048.hpp"
+#include "Game/LargeBoardGame.hpp"
+#include "Game/BoardWallView.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+int main(int argc, char** argv) {
+    int boardSize = 0; // --board N switches to the large board mode
+    int wallBoards = 0; // --wall N shows N self-play games at once
+    int wallThreads = static_cast<int>(std::thread::hardware_concurrency());
+    int wallMovesPerSecond = 10;
+    FramePacer::EMode pacingMode = FramePacer::EMode::VSYNC;
+    double targetFps = 60.0;
+    const char* capturePath = nullptr; // --capture out.y4m records a video, any other path a directory of PNG frames
+    std::string nTupleWeights; // --ntuple PATH adds the n-tuple network to the autoplay modes
+    std::string solutionTable; // --solution PATH adds exact play from a table of the game's board size
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--board") == 0 && i + 1 < argc) boardSize = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--wall") == 0 && i + 1 < argc) wallBoards = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--wall-threads") == 0 && i + 1 < argc) wallThreads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--wall-speed") == 0 && i + 1 < argc) wallMovesPerSecond = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--vsync") == 0) pacingMode = FramePacer::EMode::VSYNC;
+        else if (std::strcmp(argv[i], "--capture") == 0 && i + 1 < argc) capturePath = argv[++i];
+        else if (std::strcmp(argv[i], "--ntuple") == 0 && i + 1 < argc) nTupleWeights = argv[++i];
+        else if (std::strcmp(argv[i], "--solution") == 0 && i + 1 < argc) solutionTable = argv[++i];
+        else if (std::strcmp(argv[i], "--unlimited") == 0) pacingMode = FramePacer::EMode::UNLIMITED;
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            pacingMode = FramePacer::EMode::CAPPED;
+            targetFps = std::atof(argv[++i]);
+        }
+    }
+
 
-int main() {
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW!" << std::endl;
         return -1;
@@ -14,6 +49,8 @@ int main() {
     int window_width = 640;
     int window_height = 640;
 
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE); // 640x640 at 100% scale, larger on HiDPI monitors
+
     GLFWwindow* window = glfwCreateWindow(window_width, window_height, "2048", nullptr, nullptr);
 
     if (!window) {
@@ -30,9 +67,68 @@ int main() {
         return -1;
     }
 
-    Game2048 game(window, window_width, window_height);
+    GLExtensions::load((GLADloadproc)glfwGetProcAddress);
+
+    FramePacer framePacer(pacingMode, targetFps);
+    framePacer.applySwapInterval();
+
+    std::unique_ptr<FrameCapture> frameCapture;
+    if (capturePath) {
+        frameCapture.reset(new FrameCapture(capturePath, pacingMode == FramePacer::EMode::CAPPED ? static_cast<unsigned int>(targetFps) : 60));
+        Renderer::setFrameCapture(frameCapture.get());
+    }
+
+    int framebuffer_width, framebuffer_height;
+    glfwGetFramebufferSize(window, &framebuffer_width, &framebuffer_height);
+
+    if (wallBoards > 0) {
+        BoardWallView view(window, framebuffer_width, framebuffer_height, wallBoards, std::max(1, wallThreads), std::max(0, wallMovesPerSecond), framePacer);
+
+        view.run();
+    }
+    else if (boardSize > 0) {
+        LargeBoardGame game(window, framebuffer_width, framebuffer_height, boardSize, framePacer);
+
+        game.run();
+    }
+    else {
+        Game2048 game(window, framebuffer_width, framebuffer_height, framePacer, nTupleWeights, solutionTable);
+
+        game.run();
 
-    game.run();
+        const Game2048::FrameStats& stats = game.getFrameStats();
+        std::cout << "Frames rendered: " << stats.renderedFrames << ", skipped: " << stats.skippedFrames << std::endl;
+
+        const GameStats& gameStats = game.getGameStats();
+        std::cout << "Score: " << gameStats.score << ", best tile: " << gameStats.maxTile << ", moves: " << gameStats.moves
+            << ", merges per move: " << gameStats.getAverageMergesPerMove() << ", seconds per move: " << gameStats.getAverageMoveTime() << std::endl;
+
+        const Game2048::AutoplayStats& autoplay = game.getAutoplayStats();
+        if (autoplay.moves > 0) {
+            std::cout << "Autoplay moves: " << autoplay.moves << ", depth: " << double(autoplay.depth) / autoplay.moves
+                << ", nodes per move: " << autoplay.nodes / autoplay.moves << ", ms per move: " << autoplay.milliseconds / autoplay.moves << std::endl;
+        }
+        if (autoplay.monteCarloMoves > 0) {
+            std::cout << "Monte Carlo moves: " << autoplay.monteCarloMoves << ", rollouts per move: " << autoplay.rollouts / autoplay.monteCarloMoves
+                << ", rollouts per second: " << autoplay.rollouts / (autoplay.monteCarloMilliseconds / 1000.0 + 1e-9)
+                << ", ms per move: " << autoplay.monteCarloMilliseconds / autoplay.monteCarloMoves << std::endl;
+        }
+        if (autoplay.nTupleMoves > 0) std::cout << "N-tuple moves: " << autoplay.nTupleMoves << std::endl;
+        if (autoplay.exactMoves > 0) std::cout << "Exact moves: " << autoplay.exactMoves << std::endl;
+    }
+    if (frameCapture) {
+        frameCapture->finish();
+        Renderer::setFrameCapture(nullptr);
+
+        FrameCapture::Stats capture = frameCapture->getStats();
+        std::cout << "Frames captured: " << capture.captured << ", written: " << capture.written << ", dropped: " << capture.dropped
+            << ", repeated: " << capture.repeated << ", skipped: " << capture.skipped << std::endl;
+        frameCapture.reset();
+    }
+    FramePacer::Stats pacing = framePacer.getStats();
+    std::cout << "Frame time: " << pacing.meanFrameTime << " ms mean, " << pacing.minFrameTime << "-" << pacing.maxFrameTime << " ms range, "
+        << pacing.jitter << " ms jitter over " << pacing.frames << " frames" << std::endl;
+    ResourceManager::unloadAll();
 
     glfwTerminate();
     return 0;